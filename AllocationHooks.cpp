@@ -0,0 +1,72 @@
+//
+// Created by Max on 17/10/2026.
+// Replacement of the global allocation functions reporting to ScopedRealtimeAllocationCheck
+// Only linked into the benchmark and offline executables, never into the plugin
+//
+
+#include "AllocationTracker.h"
+#include <cstdlib>
+
+#if MUSIC_VIS_BACKEND_TRACK_ALLOCATIONS
+namespace {
+    void* allocate(std::size_t size) noexcept {
+        ScopedRealtimeAllocationCheck::allocationHappened();
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment) noexcept {
+        ScopedRealtimeAllocationCheck::allocationHappened();
+        const auto align = juce::jmax(static_cast<std::size_t>(alignment), sizeof(void*));
+       #if JUCE_WINDOWS
+        return _aligned_malloc(size == 0 ? 1 : size, align);
+       #else
+        void* ptr = nullptr;
+        return posix_memalign(&ptr, align, size == 0 ? 1 : size) == 0 ? ptr : nullptr;
+       #endif
+    }
+
+    void freeAligned(void* ptr) noexcept {
+       #if JUCE_WINDOWS
+        _aligned_free(ptr);
+       #else
+        std::free(ptr);
+       #endif
+    }
+
+    void* allocateOrThrow(std::size_t size) {
+        if(auto* ptr = allocate(size)){
+            return ptr;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* allocateAlignedOrThrow(std::size_t size, std::align_val_t alignment) {
+        if(auto* ptr = allocateAligned(size, alignment)){
+            return ptr;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAlignedOrThrow(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAlignedOrThrow(size, alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { freeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { freeAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { freeAligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { freeAligned(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(ptr); }
+#endif
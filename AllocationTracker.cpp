@@ -0,0 +1,48 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "AllocationTracker.h"
+#include <atomic>
+
+#if MUSIC_VIS_BACKEND_TRACK_ALLOCATIONS
+namespace {
+    // Nesting depth of checked scopes on the current thread
+    thread_local int checkDepth = 0;
+    std::atomic<juce::int64> numRealtimeAllocations { 0 };
+}
+
+ScopedRealtimeAllocationCheck::ScopedRealtimeAllocationCheck() {
+    checkDepth++;
+}
+
+ScopedRealtimeAllocationCheck::~ScopedRealtimeAllocationCheck() {
+    checkDepth--;
+}
+
+void ScopedRealtimeAllocationCheck::allocationHappened() noexcept {
+    if(checkDepth > 0){
+        numRealtimeAllocations++;
+        // Logging the assertion may allocate itself, so the check is suspended while it fires
+        const auto depth = checkDepth;
+        checkDepth = 0;
+        // Heap allocation on the realtime thread!
+        jassertfalse;
+        checkDepth = depth;
+    }
+}
+
+juce::int64 ScopedRealtimeAllocationCheck::getNumRealtimeAllocations() {
+    return numRealtimeAllocations.load();
+}
+#else
+ScopedRealtimeAllocationCheck::ScopedRealtimeAllocationCheck() = default;
+ScopedRealtimeAllocationCheck::~ScopedRealtimeAllocationCheck() = default;
+
+void ScopedRealtimeAllocationCheck::allocationHappened() noexcept {
+}
+
+juce::int64 ScopedRealtimeAllocationCheck::getNumRealtimeAllocations() {
+    return 0;
+}
+#endif
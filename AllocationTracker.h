@@ -0,0 +1,49 @@
+//
+// Created by Max on 17/10/2026.
+// Detection of heap allocations on the realtime thread
+//
+
+#ifndef MUSIC_VIS_BACKEND_ALLOCATIONTRACKER_H
+#define MUSIC_VIS_BACKEND_ALLOCATIONTRACKER_H
+
+#include <juce_core/juce_core.h>
+#include <new>
+
+// The checked scopes are only enabled in debug builds by default
+#ifndef MUSIC_VIS_BACKEND_TRACK_ALLOCATIONS
+ #if JUCE_DEBUG
+  #define MUSIC_VIS_BACKEND_TRACK_ALLOCATIONS 1
+ #else
+  #define MUSIC_VIS_BACKEND_TRACK_ALLOCATIONS 0
+ #endif
+#endif
+
+/**
+ * While an instance of this class is alive, every heap allocation on the constructing thread that is reported to
+ * allocationHappened() triggers an assertion. Used at the top of processBlock to make sure the audio thread never
+ * allocates. Does nothing if MUSIC_VIS_BACKEND_TRACK_ALLOCATIONS is disabled.
+ *
+ * Allocations are only reported by AllocationHooks.cpp, which replaces the global operator new/delete. It is linked
+ * into the benchmark and offline executables only (a plugin must not replace the allocator of the host process), so
+ * the check is only enforced there. In the plugin the scope has no effect.
+ */
+class ScopedRealtimeAllocationCheck {
+public:
+    ScopedRealtimeAllocationCheck();
+    ~ScopedRealtimeAllocationCheck();
+
+    /**
+     * Report a heap allocation on the calling thread. Asserts and counts it if the thread is inside a checked scope.
+     */
+    static void allocationHappened() noexcept;
+
+    /**
+     * Total number of allocations that happened inside a checked scope on any thread
+     * @return The number of allocations, always 0 if tracking is disabled
+     */
+    static juce::int64 getNumRealtimeAllocations();
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedRealtimeAllocationCheck)
+};
+
+#endif //MUSIC_VIS_BACKEND_ALLOCATIONTRACKER_H
@@ -0,0 +1,105 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "AnalysisDecimator.h"
+#include "../Constants.h"
+
+int AnalysisDecimator::getFactorForSampleRate(double sampleRate, double targetSampleRate) {
+    return jmax(1, roundToInt(sampleRate / targetSampleRate));
+}
+
+void AnalysisDecimator::prepare(int numChannels, int newFactor) {
+    factor = jmax(1, newFactor);
+    numTaps = factor == 1 ? 1 : factor * DECIMATOR_TAPS_PER_PHASE;
+
+    // Windowed sinc lowpass with its cutoff slightly below the new Nyquist frequency
+    taps.resize(numTaps);
+    if(factor == 1){
+        taps[0] = 1.0f;
+    } else {
+        const auto cutoff = DECIMATOR_CUTOFF_RATIO * 0.5 / factor;
+        const auto centre = (numTaps - 1) * 0.5;
+        double sum = 0.0;
+
+        for (int i = 0; i < numTaps; i++){
+            const auto x = i - centre;
+            const auto sinc = x == 0.0 ? 2.0 * cutoff : sin(MathConstants<double>::twoPi * cutoff * x) / (MathConstants<double>::pi * x);
+            // Blackman window
+            const auto window = 0.42 - 0.5 * cos(MathConstants<double>::twoPi * i / (numTaps - 1))
+                    + 0.08 * cos(2.0 * MathConstants<double>::twoPi * i / (numTaps - 1));
+            taps[numTaps - 1 - i] = static_cast<float>(sinc * window);
+            sum += sinc * window;
+        }
+
+        // Normalise to unity gain at DC
+        FloatVectorOperations::multiply(taps.data(), static_cast<float>(1.0 / sum), numTaps);
+    }
+
+    history.setSize(numChannels, 2 * numTaps);
+    reset();
+}
+
+void AnalysisDecimator::reset() {
+    history.clear();
+    historyPosition = 0;
+    samplesUntilOutput = factor;
+}
+
+int AnalysisDecimator::process(const float* const* inputData, float* const* outputData, int numSamples, int numChannels) {
+    jassert(numChannels <= history.getNumChannels());
+
+    if(factor == 1){
+        for (int channel = 0; channel < numChannels; channel++){
+            FloatVectorOperations::copy(outputData[channel], inputData[channel], numSamples);
+        }
+        return numSamples;
+    }
+
+    int numOutputs = 0;
+    auto countdown = samplesUntilOutput;
+    auto position = historyPosition;
+
+    for (int channel = 0; channel < numChannels; channel++){
+        auto* delayLine = history.getWritePointer(channel);
+        auto* reader = inputData[channel];
+        auto* writer = outputData[channel];
+        countdown = samplesUntilOutput;
+        position = historyPosition;
+        numOutputs = 0;
+
+        for (int i = 0; i < numSamples; i++){
+            // Write each sample twice, so delayLine[position + 1 ... position + numTaps] holds the last numTaps samples
+            delayLine[position] = reader[i];
+            delayLine[position + numTaps] = reader[i];
+            position = position + 1 == numTaps ? 0 : position + 1;
+
+            // Only the retained output samples are computed
+            if(--countdown == 0){
+                countdown = factor;
+                const auto* window = delayLine + position;
+                float sum = 0.0f;
+                for (int tap = 0; tap < numTaps; tap++){
+                    sum += window[tap] * taps[tap];
+                }
+                writer[numOutputs++] = sum;
+            }
+        }
+    }
+
+    samplesUntilOutput = countdown;
+    historyPosition = position;
+    return numOutputs;
+}
+
+int AnalysisDecimator::getMaxNumOutputSamples(int numSamples) const {
+    return numSamples / factor + 1;
+}
+
+int AnalysisDecimator::getFactor() const {
+    return factor;
+}
+
+double AnalysisDecimator::getLatency() const {
+    return (numTaps - 1) * 0.5;
+}
@@ -0,0 +1,70 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_ANALYSISDECIMATOR_H
+#define MUSIC_VIS_BACKEND_ANALYSISDECIMATOR_H
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace std;
+using namespace juce;
+
+/**
+ * Polyphase FIR decimator that brings the input down to the analysis sample rate.
+ * The anti-aliasing lowpass is a windowed sinc. Only every factor-th output sample is computed,
+ * so the cost per input sample stays constant regardless of the decimation factor.
+ */
+class AnalysisDecimator {
+public:
+    /**
+     * Choose the decimation factor that brings the sample rate closest to the target analysis rate
+     * @param sampleRate Input sample rate
+     * @param targetSampleRate Desired analysis sample rate
+     * @return The integer decimation factor (at least 1)
+     */
+    static int getFactorForSampleRate(double sampleRate, double targetSampleRate);
+
+    /**
+     * Design the filter and allocate the delay lines. Must not be called while the decimator is in use.
+     * @param numChannels Number of channels to decimate
+     * @param factor Integer decimation factor, 1 disables decimation
+     */
+    void prepare(int numChannels, int factor);
+
+    // Clear the delay lines
+    void reset();
+
+    /**
+     * Filter and decimate a block of samples
+     * @param inputData One read pointer per channel
+     * @param outputData One write pointer per channel, each holding at least getNumOutputSamples(numSamples) samples
+     * @param numSamples Number of input samples per channel
+     * @param numChannels Number of channels to process, starting with the first one. The histories of the other
+     * channels are not updated.
+     * @return The number of output samples written per channel
+     */
+    int process(const float* const* inputData, float* const* outputData, int numSamples, int numChannels);
+
+    // Upper bound for the number of output samples produced from numSamples input samples
+    int getMaxNumOutputSamples(int numSamples) const;
+
+    int getFactor() const;
+
+    // Group delay of the filter in input samples
+    double getLatency() const;
+
+private:
+    int factor = 1;
+    int numTaps = 0;
+    // Filter coefficients, stored in reverse order so they line up with the delay line
+    vector<float> taps;
+    // Delay line per channel, stored twice in a row so the last numTaps samples are always contiguous
+    AudioBuffer<float> history;
+    int historyPosition = 0;
+    // Number of input samples until the next output sample is due
+    int samplesUntilOutput = 1;
+};
+
+
+#endif //MUSIC_VIS_BACKEND_ANALYSISDECIMATOR_H
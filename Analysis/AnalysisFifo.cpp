@@ -0,0 +1,69 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "AnalysisFifo.h"
+
+void AnalysisFifo::prepare(int numChannels, int capacity) {
+    // AbstractFifo keeps one slot free to distinguish between full and empty
+    storage.setSize(numChannels, capacity + 1);
+    storage.clear();
+    fifo.setTotalSize(capacity + 1);
+    fifo.reset();
+}
+
+void AnalysisFifo::reset() {
+    fifo.reset();
+}
+
+int AnalysisFifo::push(const float* const* leftData, const float* const* rightData, int numSamples, float leftGain, float rightGain) {
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    for (int channel = 0; channel < storage.getNumChannels(); channel++){
+        auto* writer = storage.getWritePointer(channel);
+        auto* left = leftData[channel];
+        auto* right = rightData[channel];
+
+        if(left == nullptr){
+            FloatVectorOperations::clear(writer + start1, size1);
+            FloatVectorOperations::clear(writer + start2, size2);
+        } else if(right == nullptr || rightGain == 0.0f){
+            FloatVectorOperations::copyWithMultiply(writer + start1, left, leftGain, size1);
+            FloatVectorOperations::copyWithMultiply(writer + start2, left + size1, leftGain, size2);
+        } else {
+            mix(writer + start1, left, right, leftGain, rightGain, size1);
+            mix(writer + start2, left + size1, right + size1, leftGain, rightGain, size2);
+        }
+    }
+
+    fifo.finishedWrite(size1 + size2);
+    return size1 + size2;
+}
+
+void AnalysisFifo::mix(float* dest, const float* left, const float* right, float leftGain, float rightGain, int numSamples) {
+    FloatVectorOperations::copyWithMultiply(dest, left, leftGain, numSamples);
+    FloatVectorOperations::addWithMultiply(dest, right, rightGain, numSamples);
+}
+
+int AnalysisFifo::pop(float* const* destData, int numSamples) {
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numSamples, start1, size1, start2, size2);
+
+    for (int channel = 0; channel < storage.getNumChannels(); channel++){
+        auto* reader = storage.getReadPointer(channel);
+        FloatVectorOperations::copy(destData[channel], reader + start1, size1);
+        FloatVectorOperations::copy(destData[channel] + size1, reader + start2, size2);
+    }
+
+    fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
+
+int AnalysisFifo::getNumReady() const {
+    return fifo.getNumReady();
+}
+
+int AnalysisFifo::getNumChannels() const {
+    return storage.getNumChannels();
+}
@@ -0,0 +1,66 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_ANALYSISFIFO_H
+#define MUSIC_VIS_BACKEND_ANALYSISFIFO_H
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+/**
+ * Lock-free single-producer/single-consumer FIFO for multichannel audio.
+ * The audio thread pushes samples, the analysis worker pops them. All channels share one read/write position,
+ * so a pop always returns time-aligned samples for every channel.
+ */
+class AnalysisFifo {
+public:
+    /**
+     * Allocate the storage. Must not be called while either thread is using the FIFO.
+     * @param numChannels Number of channels to store
+     * @param capacity Maximum number of samples per channel the FIFO can hold
+     */
+    void prepare(int numChannels, int capacity);
+
+    /**
+     * Discard all queued samples. Must not be called while either thread is using the FIFO.
+     */
+    void reset();
+
+    /**
+     * Mix two sets of channels into the FIFO (audio thread). Each FIFO channel receives
+     * leftGain * leftData[channel] + rightGain * rightData[channel], computed with vectorised operations while copying.
+     * Channels passed as nullptr in leftData are written as silence.
+     * @param leftData One read pointer per channel for the left input
+     * @param rightData One read pointer per channel for the right input
+     * @param numSamples Number of samples per channel
+     * @param leftGain Gain applied to the left input
+     * @param rightGain Gain applied to the right input
+     * @return The number of samples that were actually written
+     */
+    int push(const float* const* leftData, const float* const* rightData, int numSamples, float leftGain, float rightGain);
+
+    /**
+     * Copy samples out of the FIFO (worker thread).
+     * @param destData One write pointer per channel
+     * @param numSamples Number of samples per channel to read
+     * @return The number of samples that were actually read
+     */
+    int pop(float* const* destData, int numSamples);
+
+    // Number of samples per channel that are ready to be read
+    int getNumReady() const;
+
+    int getNumChannels() const;
+
+private:
+    // dest = leftGain * left + rightGain * right with JUCE's SIMD vector operations
+    static void mix(float* dest, const float* left, const float* right, float leftGain, float rightGain, int numSamples);
+
+    AbstractFifo fifo { 1 };
+    AudioBuffer<float> storage;
+};
+
+
+#endif //MUSIC_VIS_BACKEND_ANALYSISFIFO_H
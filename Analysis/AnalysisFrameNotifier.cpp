@@ -0,0 +1,38 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "AnalysisFrameNotifier.h"
+
+void AnalysisFrameNotifier::addListener(Listener* listener) {
+    for (auto& slot : listeners){
+        Listener* expected = nullptr;
+        if(slot.compare_exchange_strong(expected, listener)){
+            return;
+        }
+    }
+    // All slots are taken
+    jassertfalse;
+}
+
+void AnalysisFrameNotifier::removeListener(Listener* listener) {
+    for (auto& slot : listeners){
+        Listener* expected = listener;
+        slot.compare_exchange_strong(expected, nullptr);
+    }
+
+    // The analysis thread may have loaded the listener just before it was removed
+    while (notifying.load()){
+        Thread::yield();
+    }
+}
+
+void AnalysisFrameNotifier::notify() {
+    notifying.store(true);
+    for (auto& slot : listeners){
+        if(auto* listener = slot.load()){
+            listener->analysisFrameReady();
+        }
+    }
+    notifying.store(false);
+}
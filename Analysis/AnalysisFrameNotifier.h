@@ -0,0 +1,48 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_ANALYSISFRAMENOTIFIER_H
+#define MUSIC_VIS_BACKEND_ANALYSISFRAMENOTIFIER_H
+
+#include <juce_core/juce_core.h>
+#include "../Constants.h"
+
+using namespace std;
+using namespace juce;
+
+/**
+ * Tells the consumers of the analysis results (publisher, GUI) that a new frame has been analysed.
+ * Listeners are kept in a fixed number of atomic slots, so notifying them never locks or allocates. Removing a
+ * listener waits until a notification in progress has finished, so a listener can safely be deleted afterwards.
+ */
+class AnalysisFrameNotifier {
+public:
+    class Listener {
+    public:
+        virtual ~Listener() = default;
+
+        /**
+         * Called on the analysis thread after the results of a frame have been published.
+         * Must return quickly and must not block, typically it only wakes up another thread.
+         */
+        virtual void analysisFrameReady() = 0;
+    };
+
+    // Register a listener, at most ANALYSIS_MAX_FRAME_LISTENERS at a time
+    void addListener(Listener* listener);
+
+    // Unregister a listener, returns once it is guaranteed not to be called anymore
+    void removeListener(Listener* listener);
+
+    // Call all registered listeners (analysis thread)
+    void notify();
+
+private:
+    array<atomic<Listener*>, ANALYSIS_MAX_FRAME_LISTENERS> listeners {};
+    // Set while notify() is calling the listeners
+    atomic<bool> notifying { false };
+};
+
+
+#endif //MUSIC_VIS_BACKEND_ANALYSISFRAMENOTIFIER_H
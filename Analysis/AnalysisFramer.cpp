@@ -0,0 +1,79 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "AnalysisFramer.h"
+
+void AnalysisFramer::prepare(int numChannels, int newFrameSize, int newHopSize) {
+    jassert(newHopSize > 0 && newHopSize <= newFrameSize);
+
+    frameSize = newFrameSize;
+    hopSize = newHopSize;
+    ring.setSize(numChannels, frameSize);
+    reset();
+}
+
+void AnalysisFramer::reset() {
+    ring.clear();
+    writePosition = 0;
+    samplesUntilNextFrame = hopSize;
+    frameReady = false;
+}
+
+int AnalysisFramer::write(const float* const* channelData, int startSample, int numSamples, int numChannels) {
+    jassert(numChannels <= ring.getNumChannels());
+
+    // The ready frame has to be read before it is overwritten
+    if(frameReady){
+        return 0;
+    }
+
+    const auto numToWrite = jmin(numSamples, samplesUntilNextFrame);
+    const auto numBeforeWrap = jmin(numToWrite, frameSize - writePosition);
+
+    for (int channel = 0; channel < numChannels; channel++){
+        auto* writer = ring.getWritePointer(channel);
+        auto* reader = channelData[channel] + startSample;
+        FloatVectorOperations::copy(writer + writePosition, reader, numBeforeWrap);
+        FloatVectorOperations::copy(writer, reader + numBeforeWrap, numToWrite - numBeforeWrap);
+    }
+
+    writePosition = (writePosition + numToWrite) % frameSize;
+    samplesUntilNextFrame -= numToWrite;
+
+    if(samplesUntilNextFrame == 0){
+        frameReady = true;
+        samplesUntilNextFrame = hopSize;
+    }
+
+    return numToWrite;
+}
+
+bool AnalysisFramer::isFrameReady() const {
+    return frameReady;
+}
+
+void AnalysisFramer::readFrame(float* const* destData, int numChannels) {
+    // Linearise the ring: oldest samples start at the write position
+    const auto numUntilEnd = frameSize - writePosition;
+
+    for (int channel = 0; channel < numChannels; channel++){
+        auto* reader = ring.getReadPointer(channel);
+        FloatVectorOperations::copy(destData[channel], reader + writePosition, numUntilEnd);
+        FloatVectorOperations::copy(destData[channel] + numUntilEnd, reader, writePosition);
+    }
+
+    frameReady = false;
+}
+
+int AnalysisFramer::getNumSamplesUntilNextFrame() const {
+    return samplesUntilNextFrame;
+}
+
+int AnalysisFramer::getFrameSize() const {
+    return frameSize;
+}
+
+int AnalysisFramer::getHopSize() const {
+    return hopSize;
+}
@@ -0,0 +1,71 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_ANALYSISFRAMER_H
+#define MUSIC_VIS_BACKEND_ANALYSISFRAMER_H
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+/**
+ * Short-time framing independent of the host block size.
+ * Incoming samples of any length are accumulated in a ring buffer per channel. Every hopSize samples a new frame
+ * of the last frameSize samples becomes ready, so consecutive frames overlap by frameSize - hopSize samples.
+ */
+class AnalysisFramer {
+public:
+    /**
+     * Allocate the ring buffer. Must not be called while the framer is in use.
+     * @param numChannels Number of channels to frame
+     * @param frameSize Number of samples per frame
+     * @param hopSize Number of samples between the starts of two consecutive frames, must not exceed frameSize
+     */
+    void prepare(int numChannels, int frameSize, int hopSize);
+
+    /**
+     * Clear the history and start over with an empty (silent) frame
+     */
+    void reset();
+
+    /**
+     * Append samples to the ring buffer. Writing stops at the next frame boundary, so callers have to
+     * read the ready frame with readFrame() and call write() again with the remaining samples.
+     * @param channelData One read pointer per channel
+     * @param startSample Offset into channelData
+     * @param numSamples Number of samples available in channelData after startSample
+     * @param numChannels Number of channels to write, starting with the first one
+     * @return The number of samples that were consumed
+     */
+    int write(const float* const* channelData, int startSample, int numSamples, int numChannels);
+
+    // Whether a complete frame is waiting to be read
+    bool isFrameReady() const;
+
+    /**
+     * Copy the current frame (oldest sample first) into the destination buffers
+     * @param destData One write pointer per channel, each holding at least frameSize samples
+     * @param numChannels Number of channels to read, starting with the first one
+     */
+    void readFrame(float* const* destData, int numChannels);
+
+    // Number of samples that still have to be written before the next frame is ready
+    int getNumSamplesUntilNextFrame() const;
+
+    int getFrameSize() const;
+    int getHopSize() const;
+
+private:
+    AudioBuffer<float> ring;
+    int frameSize = 0;
+    int hopSize = 0;
+
+    // Position of the next write, which is also the position of the oldest sample
+    int writePosition = 0;
+    int samplesUntilNextFrame = 0;
+    bool frameReady = false;
+};
+
+
+#endif //MUSIC_VIS_BACKEND_ANALYSISFRAMER_H
@@ -0,0 +1,45 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "AnalysisGovernor.h"
+
+void AnalysisGovernor::prepare(double newHopDurationMs) {
+    hopDurationMs = newHopDurationMs;
+    load = 0.0;
+    level = 0;
+    framesSinceLevelChange = 0;
+}
+
+void AnalysisGovernor::setEnabled(bool shouldBeEnabled) {
+    enabled = shouldBeEnabled;
+    if(!enabled){
+        level = 0;
+    }
+}
+
+void AnalysisGovernor::frameAnalysed(double milliseconds) {
+    if(hopDurationMs <= 0.0){
+        return;
+    }
+    load += ANALYSIS_LOAD_SMOOTHING * (milliseconds / hopDurationMs - load);
+
+    if(!enabled || ++framesSinceLevelChange < ANALYSIS_GOVERNOR_HOLD_FRAMES){
+        return;
+    }
+    if(load > ANALYSIS_LOAD_BUDGET && level < ANALYSIS_MAX_SHEDDING_LEVEL){
+        level++;
+        framesSinceLevelChange = 0;
+    } else if(load < ANALYSIS_LOAD_BUDGET * ANALYSIS_LOAD_RECOVERY_RATIO && level > 0){
+        level--;
+        framesSinceLevelChange = 0;
+    }
+}
+
+float AnalysisGovernor::getLoad() const {
+    return static_cast<float>(load);
+}
+
+int AnalysisGovernor::getLevel() const {
+    return level;
+}
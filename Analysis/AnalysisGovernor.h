@@ -0,0 +1,49 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_ANALYSISGOVERNOR_H
+#define MUSIC_VIS_BACKEND_ANALYSISGOVERNOR_H
+
+#include <juce_core/juce_core.h>
+#include "../Constants.h"
+
+using namespace std;
+using namespace juce;
+
+/**
+ * Quality governor of the analysis thread.
+ * Compares the smoothed time spent per frame to a budget of ANALYSIS_LOAD_BUDGET times the hop duration, i.e. the time
+ * the worker has per frame in realtime. If the load exceeds the budget, the shedding level is raised by one, so the
+ * expensive (sheddable, see AnalysisScheduler) features are computed half as often and hold their previous value in
+ * between. Once the load drops below ANALYSIS_LOAD_RECOVERY_RATIO times the budget, the level is lowered again. Levels
+ * change at most every ANALYSIS_GOVERNOR_HOLD_FRAMES frames, so the governor doesn't oscillate. Cheap features always
+ * run at their scheduled rate. Only accessed by the analysis thread.
+ */
+class AnalysisGovernor {
+public:
+    // Start at full rate, hopDurationMs is the time between two frames in realtime
+    void prepare(double hopDurationMs);
+
+    // Without load shedding the level stays at 0, e.g. when rendering offline
+    void setEnabled(bool shouldBeEnabled);
+
+    // Report the time spent on a frame and adapt the shedding level
+    void frameAnalysed(double milliseconds);
+
+    // Smoothed time per frame relative to the hop duration, i.e. 1 means the analysis only just keeps up
+    float getLoad() const;
+
+    // Sheddable features are computed 2^level times less often than scheduled
+    int getLevel() const;
+
+private:
+    double hopDurationMs = 0.0;
+    bool enabled = true;
+    double load = 0.0;
+    int level = 0;
+    int framesSinceLevelChange = 0;
+};
+
+
+#endif //MUSIC_VIS_BACKEND_ANALYSISGOVERNOR_H
@@ -0,0 +1,125 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "AnalysisProfiler.h"
+#include "FeatureFrame.h"
+
+void TimingHistogram::record(double microseconds) {
+    // Fractional octaves above the lowest bucket, anything faster ends up in the first and anything slower in the last
+    const auto octaves = std::log2(jmax(microseconds, TIMING_HISTOGRAM_MIN_MICROSECONDS) / TIMING_HISTOGRAM_MIN_MICROSECONDS);
+    const auto bucket = jmin(TIMING_HISTOGRAM_BUCKETS - 1, static_cast<int>(octaves * TIMING_HISTOGRAM_BUCKETS_PER_OCTAVE));
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    const auto value = static_cast<float>(microseconds);
+    if(value > currentMax.load(std::memory_order_relaxed)){
+        currentMax.store(value, std::memory_order_relaxed);
+    }
+
+    // Let old recordings fade out, readers may briefly see a partly halved histogram
+    if(++numInWindow >= TIMING_HISTOGRAM_WINDOW){
+        numInWindow = 0;
+        for (auto& count : buckets){
+            count.store(count.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+        }
+        previousMax.store(currentMax.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        currentMax.store(0.0f, std::memory_order_relaxed);
+    }
+}
+
+TimingHistogram::Summary TimingHistogram::getSummary() const {
+    array<uint32, TIMING_HISTOGRAM_BUCKETS> counts {};
+    Summary summary;
+    for (int i = 0; i < TIMING_HISTOGRAM_BUCKETS; i++){
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        summary.numRecordings += counts[i];
+    }
+    summary.max = jmax(currentMax.load(std::memory_order_relaxed), previousMax.load(std::memory_order_relaxed));
+    if(summary.numRecordings == 0){
+        return summary;
+    }
+
+    // Walk up the buckets until half / 99 percent of the recordings are below
+    const auto p50Rank = (summary.numRecordings + 1) / 2;
+    const auto p99Rank = summary.numRecordings - summary.numRecordings / 100;
+    uint32 cumulative = 0;
+    bool p50Found = false;
+    for (int i = 0; i < TIMING_HISTOGRAM_BUCKETS; i++){
+        cumulative += counts[i];
+        if(!p50Found && cumulative >= p50Rank){
+            summary.p50 = getBucketUpperEdge(i);
+            p50Found = true;
+        }
+        if(cumulative >= p99Rank){
+            summary.p99 = getBucketUpperEdge(i);
+            break;
+        }
+    }
+
+    // The bucket edges may exceed the largest recording
+    summary.p50 = jmin(summary.p50, summary.max);
+    summary.p99 = jmin(summary.p99, summary.max);
+    return summary;
+}
+
+void TimingHistogram::reset() {
+    for (auto& count : buckets){
+        count.store(0);
+    }
+    currentMax.store(0.0f);
+    previousMax.store(0.0f);
+    numInWindow = 0;
+}
+
+float TimingHistogram::getBucketUpperEdge(int bucket) {
+    return static_cast<float>(TIMING_HISTOGRAM_MIN_MICROSECONDS
+                              * std::exp2(static_cast<double>(bucket + 1) / TIMING_HISTOGRAM_BUCKETS_PER_OCTAVE));
+}
+
+String AnalysisProfiler::getStageName(Stage stage) {
+    switch (stage){
+        case DECIMATION: return "Decimation";
+        case BAND_SPLITTING: return "Band Splitting";
+        case WINDOWING: return "Windowing";
+        case SPECTRUM: return "Spectrum";
+        case SPECTRAL_CENTROID: return "Spectral Centroid";
+        case PITCH_YIN: return "Pitch (YIN)";
+        case LOUDNESS: return "Loudness";
+        case ONSET_DETECTION: return "Onset Detection";
+        case SPECTRAL_PEAKS: return "Spectral Peaks";
+        case DISSONANCE: return "Dissonance";
+        case MEL_BANDS: return "Mel Bands";
+        case BAND_SPECTRA: return "Band Spectra";
+        case FRAME: return "Whole Frame";
+        default: return {};
+    }
+}
+
+String AnalysisProfiler::getStagePropertyID(Stage stage) {
+    return "timing" + getStageName(stage).removeCharacters(" ()");
+}
+
+TimingHistogram& AnalysisProfiler::getStage(Stage stage) {
+    return stages[stage];
+}
+
+const TimingHistogram& AnalysisProfiler::getStage(Stage stage) const {
+    return stages[stage];
+}
+
+TimingHistogram& AnalysisProfiler::getSlot(int band, int slot) {
+    return slots[FeatureFrame::getSlotIndex(band, slot)];
+}
+
+const TimingHistogram& AnalysisProfiler::getSlot(int band, int slot) const {
+    return slots[FeatureFrame::getSlotIndex(band, slot)];
+}
+
+void AnalysisProfiler::reset() {
+    for (auto& stage : stages){
+        stage.reset();
+    }
+    for (auto& slot : slots){
+        slot.reset();
+    }
+}
@@ -0,0 +1,120 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_ANALYSISPROFILER_H
+#define MUSIC_VIS_BACKEND_ANALYSISPROFILER_H
+
+#include <juce_core/juce_core.h>
+#include "../Constants.h"
+
+using namespace std;
+using namespace juce;
+
+/**
+ * Histogram of the durations of one analysis stage.
+ * Only the analysis thread records, any thread can read a summary. The buckets are spaced logarithmically
+ * (TIMING_HISTOGRAM_BUCKETS_PER_OCTAVE per octave from TIMING_HISTOGRAM_MIN_MICROSECONDS), so recording is a single
+ * relaxed atomic increment. Every TIMING_HISTOGRAM_WINDOW recordings all counts are halved and the maximum is carried
+ * over for one window only, so the summary follows the recent load instead of the whole session.
+ */
+class TimingHistogram {
+public:
+    /**
+     * Percentiles and maximum in microseconds. The percentiles are the upper edges of their buckets, i.e. accurate to
+     * a quarter octave.
+     */
+    struct Summary {
+        float p50 = 0.0f;
+        float p99 = 0.0f;
+        float max = 0.0f;
+        uint32 numRecordings = 0;
+    };
+
+    // Add a duration (analysis thread only)
+    void record(double microseconds);
+
+    // Summary of the recent recordings, lock-free and callable from any thread
+    Summary getSummary() const;
+
+    // Forget all recordings, only while the analysis thread is stopped
+    void reset();
+
+private:
+    static float getBucketUpperEdge(int bucket);
+
+    array<atomic<uint32>, TIMING_HISTOGRAM_BUCKETS> buckets {};
+    // Maximum of the current and of the previous window
+    atomic<float> currentMax { 0.0f };
+    atomic<float> previousMax { 0.0f };
+    // Recordings since the counts were halved (analysis thread only)
+    int numInWindow = 0;
+};
+
+/**
+ * Timing histograms of all analysis stages: each global Essentia algorithm, the decimation, the band splitting, the
+ * band spectra, each FeatureSlot and the complete frame.
+ */
+class AnalysisProfiler {
+public:
+    /**
+     * Enum for the timed stages of the analysis, besides the FeatureSlots
+     */
+    enum Stage {
+        DECIMATION,
+        BAND_SPLITTING,
+        WINDOWING,
+        SPECTRUM,
+        SPECTRAL_CENTROID,
+        PITCH_YIN,
+        LOUDNESS,
+        ONSET_DETECTION,
+        SPECTRAL_PEAKS,
+        DISSONANCE,
+        MEL_BANDS,
+        BAND_SPECTRA,
+        FRAME,
+        NUMBER_OF_STAGES
+    };
+
+    // Name shown in the diagnostics panel
+    static String getStageName(Stage stage);
+    // Identifier of the stage's GUI property, e.g. "timingPitchYIN"
+    static String getStagePropertyID(Stage stage);
+
+    TimingHistogram& getStage(Stage stage);
+    const TimingHistogram& getStage(Stage stage) const;
+
+    // Histogram of FeatureSlotProcessor::compute() of a slot (0-based, see FeatureFrame::getSlotIndex())
+    // The first spectral slot of a band includes the band's spectrum, which BAND_SPECTRA records on its own as well
+    TimingHistogram& getSlot(int band, int slot);
+    const TimingHistogram& getSlot(int band, int slot) const;
+
+    // Forget all recordings, only while the analysis thread is stopped
+    void reset();
+
+private:
+    array<TimingHistogram, NUMBER_OF_STAGES> stages;
+    array<TimingHistogram, MAX_NUMBER_OF_BANDS * NUMBER_OF_SLOTS> slots;
+};
+
+/**
+ * Records the lifetime of the object into a TimingHistogram, e.g. around a compute() call
+ */
+class ScopedAnalysisTimer {
+public:
+    explicit ScopedAnalysisTimer(TimingHistogram& histogram) : histogram(histogram), start(Time::getHighResolutionTicks()) {}
+
+    ~ScopedAnalysisTimer() {
+        histogram.record(1.0e6 * Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start));
+    }
+
+private:
+    TimingHistogram& histogram;
+    const int64 start;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedAnalysisTimer)
+};
+
+
+#endif //MUSIC_VIS_BACKEND_ANALYSISPROFILER_H
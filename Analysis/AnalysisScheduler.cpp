@@ -0,0 +1,108 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include <limits>
+#include <numeric>
+#include "AnalysisScheduler.h"
+
+namespace {
+    /**
+     * Declared requirements of a scheduled feature
+     */
+    struct FeatureSchedule {
+        const char* name;
+        // Minimum update rate in Hz, 0 means every frame
+        double rateHz;
+        // Rough cost relative to the spectral centroid, only used for staggering
+        float relativeCost;
+        bool sheddable;
+    };
+
+    // Indexed by AnalysisScheduler::Feature
+    const FeatureSchedule schedules[AnalysisScheduler::NUMBER_OF_FEATURES] = {
+            { "Loudness", 0.0, 1.0f, false },
+            { "Onset Detection", 0.0, 1.0f, false },
+            { "Spectral Centroid", 30.0, 1.0f, false },
+            { "Mel Bands", SPECTRUM_PUBLISH_RATE_HZ, 2.0f, false },
+            { "Pitch (YIN)", 20.0, 8.0f, true },
+            { "Dissonance", 15.0, 6.0f, true },
+    };
+}
+
+String AnalysisScheduler::getFeatureName(Feature feature) {
+    return schedules[feature].name;
+}
+
+bool AnalysisScheduler::isSheddable(Feature feature) {
+    return schedules[feature].sheddable;
+}
+
+void AnalysisScheduler::prepare(double frameRateHz) {
+    frameRate = frameRateHz;
+
+    // Largest power of two interval that still meets the declared rate
+    int hyperperiod = 1;
+    for (int feature = 0; feature < NUMBER_OF_FEATURES; feature++){
+        int interval = 1;
+        if(schedules[feature].rateHz > 0.0){
+            while (interval < ANALYSIS_MAX_SCHEDULE_INTERVAL && frameRate / (interval * 2) >= schedules[feature].rateHz){
+                interval *= 2;
+            }
+        }
+        intervals[feature] = interval;
+        phases[feature] = 0;
+        hyperperiod = jmax(hyperperiod, interval);
+    }
+
+    // Stagger the features, the most expensive first: each takes the phase whose frames carry the least cost so far
+    // As all intervals are powers of two, the pattern repeats after the longest interval
+    array<float, ANALYSIS_MAX_SCHEDULE_INTERVAL> frameCosts {};
+    array<int, NUMBER_OF_FEATURES> order {};
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [](int a, int b){
+        return schedules[a].relativeCost > schedules[b].relativeCost;
+    });
+
+    for (auto feature : order){
+        const auto interval = intervals[feature];
+        auto bestPhase = 0;
+        auto bestCost = std::numeric_limits<float>::max();
+        for (int phase = 0; phase < interval; phase++){
+            auto cost = 0.0f;
+            for (int frame = phase; frame < hyperperiod; frame += interval){
+                cost = jmax(cost, frameCosts[frame]);
+            }
+            if(cost < bestCost){
+                bestCost = cost;
+                bestPhase = phase;
+            }
+        }
+
+        phases[feature] = bestPhase;
+        for (int frame = bestPhase; frame < hyperperiod; frame += interval){
+            frameCosts[frame] += schedules[feature].relativeCost;
+        }
+    }
+}
+
+void AnalysisScheduler::setEnabled(bool shouldBeEnabled) {
+    enabled = shouldBeEnabled;
+}
+
+bool AnalysisScheduler::shouldCompute(Feature feature, uint32 frameNumber, int sheddingLevel) const {
+    // The phase is smaller than the base interval, so it stays valid for the longer intervals of shedding levels
+    const auto interval = getInterval(feature, sheddingLevel);
+    return static_cast<int>(frameNumber % static_cast<uint32>(interval)) == phases[feature] % interval;
+}
+
+int AnalysisScheduler::getInterval(Feature feature, int sheddingLevel) const {
+    if(!enabled){
+        return 1;
+    }
+    return intervals[feature] << (isSheddable(feature) ? sheddingLevel : 0);
+}
+
+float AnalysisScheduler::getRate(Feature feature, int sheddingLevel) const {
+    return static_cast<float>(frameRate / getInterval(feature, sheddingLevel));
+}
@@ -0,0 +1,67 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_ANALYSISSCHEDULER_H
+#define MUSIC_VIS_BACKEND_ANALYSISSCHEDULER_H
+
+#include <juce_core/juce_core.h>
+#include "../Constants.h"
+
+using namespace std;
+using namespace juce;
+
+/**
+ * Decides in which analysis frames each global feature is computed.
+ * Every feature declares the rate it needs (see the table in AnalysisScheduler.cpp). It is computed every interval-th
+ * frame, where the interval is the largest power of two that still meets the declared rate at the current frame rate.
+ * The features are staggered: each one gets a phase within its interval, chosen so that the expected cost is spread
+ * as evenly as possible over the frames instead of all expensive features landing on the same frame.
+ * Features that may be degraded by the AnalysisGovernor are computed 2^level times less often on top, which keeps
+ * their phases. Only accessed by the analysis thread after prepare().
+ */
+class AnalysisScheduler {
+public:
+    /**
+     * Enum for the scheduled global features
+     */
+    enum Feature {
+        LOUDNESS,
+        ONSET_DETECTION,
+        SPECTRAL_CENTROID,
+        MEL_BANDS,
+        PITCH,
+        // Spectral peaks and dissonance, which depends on them
+        DISSONANCE,
+        NUMBER_OF_FEATURES
+    };
+
+    static String getFeatureName(Feature feature);
+
+    // Whether the AnalysisGovernor may lower the rate of the feature under load
+    static bool isSheddable(Feature feature);
+
+    // Derive the intervals and phases for the rate at which frames are analysed
+    void prepare(double frameRateHz);
+
+    // Without scheduling every feature is computed every frame, e.g. when rendering offline
+    void setEnabled(bool shouldBeEnabled);
+
+    // Whether the feature is due in the given frame at the governor's current shedding level
+    bool shouldCompute(Feature feature, uint32 frameNumber, int sheddingLevel) const;
+
+    // Number of frames between two computations of the feature, 1 is every frame
+    int getInterval(Feature feature, int sheddingLevel) const;
+
+    // Actual update rate of the feature in Hz
+    float getRate(Feature feature, int sheddingLevel) const;
+
+private:
+    double frameRate = 0.0;
+    bool enabled = true;
+    array<int, NUMBER_OF_FEATURES> intervals {};
+    array<int, NUMBER_OF_FEATURES> phases {};
+};
+
+
+#endif //MUSIC_VIS_BACKEND_ANALYSISSCHEDULER_H
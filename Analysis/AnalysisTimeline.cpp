@@ -0,0 +1,45 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "AnalysisTimeline.h"
+#include "../Constants.h"
+
+void AnalysisTimeline::prepare(double newSampleRate) {
+    sampleRate = newSampleRate;
+    // AbstractFifo keeps one slot free to distinguish between full and empty
+    anchors.resize(ANALYSIS_TIMELINE_ANCHORS + 1);
+    fifo.setTotalSize(ANALYSIS_TIMELINE_ANCHORS + 1);
+    fifo.reset();
+    current = { 0, 0, Time::getMillisecondCounterHiRes() };
+}
+
+void AnalysisTimeline::addAnchor(int64 streamSample, int64 hostSample, double timeMs) {
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if(size1 > 0){
+        anchors[static_cast<size_t>(start1)] = { streamSample, hostSample, timeMs };
+        fifo.finishedWrite(1);
+    }
+}
+
+void AnalysisTimeline::lookUp(double streamSample, double& hostSample, double& timeMs) {
+    // Advance to the latest anchor that is not ahead of the queried sample
+    while (fifo.getNumReady() > 0){
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(1, start1, size1, start2, size2);
+        const auto& next = anchors[static_cast<size_t>(start1)];
+
+        if(static_cast<double>(next.streamSample) > streamSample){
+            break;
+        }
+
+        current = next;
+        fifo.finishedRead(1);
+    }
+
+    const auto offset = streamSample - static_cast<double>(current.streamSample);
+    hostSample = static_cast<double>(current.hostSample) + offset;
+    timeMs = current.timeMs + 1000.0 * offset / sampleRate;
+}
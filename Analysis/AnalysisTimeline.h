@@ -0,0 +1,61 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_ANALYSISTIMELINE_H
+#define MUSIC_VIS_BACKEND_ANALYSISTIMELINE_H
+
+#include <juce_core/juce_core.h>
+
+using namespace std;
+using namespace juce;
+
+/**
+ * Maps positions in the analysed sample stream back to the host's timeline.
+ * The audio thread adds an anchor for every block it hands over, holding the block's host sample position and the
+ * time at which it was processed. Anchors are passed through a lock-free single-producer/single-consumer queue, so
+ * the worker can look up the host position and time of any sample it has popped, even if the host jumps (loops,
+ * relocation) or samples were dropped in between.
+ */
+class AnalysisTimeline {
+public:
+    /**
+     * Start a new timeline. Must not be called while either thread is using the timeline.
+     * @param sampleRate Host sample rate, used to extrapolate times between anchors
+     */
+    void prepare(double sampleRate);
+
+    /**
+     * Add an anchor for the next samples pushed into the stream (audio thread). If the queue is full, the anchor is
+     * dropped and its samples are extrapolated from the previous one.
+     * @param streamSample Index of the first sample of the block in the analysed stream
+     * @param hostSample Host sample position of that sample
+     * @param timeMs Time at which the block was processed (Time::getMillisecondCounterHiRes())
+     */
+    void addAnchor(int64 streamSample, int64 hostSample, double timeMs);
+
+    /**
+     * Look up a position in the analysed stream (worker thread). Queries must be (roughly) ascending, as anchors
+     * before the queried sample are discarded.
+     * @param streamSample Index in the analysed stream, may be fractional
+     * @param hostSample Set to the corresponding host sample position
+     * @param timeMs Set to the corresponding time
+     */
+    void lookUp(double streamSample, double& hostSample, double& timeMs);
+
+private:
+    struct Anchor {
+        int64 streamSample;
+        int64 hostSample;
+        double timeMs;
+    };
+
+    AbstractFifo fifo { 1 };
+    vector<Anchor> anchors;
+    // Latest anchor at or before the last queried sample
+    Anchor current { 0, 0, 0.0 };
+    double sampleRate = 44100.0;
+};
+
+
+#endif //MUSIC_VIS_BACKEND_ANALYSISTIMELINE_H
@@ -0,0 +1,382 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "AnalysisWorker.h"
+
+AnalysisWorker::AnalysisWorker(vector<vector<unique_ptr<FeatureSlotProcessor>>>& slots)
+        : Thread("music-vis-backend analysis"), bandSlots(slots) {
+}
+
+AnalysisWorker::~AnalysisWorker() {
+    stopThread(ANALYSIS_THREAD_STOP_TIMEOUT_MS);
+}
+
+void AnalysisWorker::prepare(double newSampleRate, int newMaximumBlockSize, int frameSize, int hopSize) {
+    // Algorithms and buffers are owned by the worker thread, so they must never be touched while it is running
+    jassert(!isThreadRunning());
+    // The spectrum is computed on whole frames, which have to be a power of two no matter what the host sends
+    jassert(isPowerOfTwo(frameSize));
+
+    // Allocate buffers once, the worker only ever overwrites their contents
+    eGlobalAudioBuffer.assign(frameSize, 0.0f);
+    for (auto& bandGraph : bandGraphs){
+        bandGraph.prepare(frameSize);
+        bandGraph.setSpectrumTiming(&profiler.getStage(AnalysisProfiler::BAND_SPECTRA));
+    }
+
+    inputSampleRate = newSampleRate;
+    maximumBlockSize = newMaximumBlockSize;
+
+    // Decimate to the analysis sample rate, all algorithms run at that rate
+    const auto factor = AnalysisDecimator::getFactorForSampleRate(inputSampleRate, ANALYSIS_TARGET_SAMPLE_RATE);
+    // Only the source signal is transported and decimated, the sub-bands are derived from it afterwards
+    decimator.prepare(1, factor);
+    const auto sampleRate = inputSampleRate / factor;
+    analysisSampleRate = sampleRate;
+
+    fifo.prepare(1, jmax(maximumBlockSize, frameSize * factor) * ANALYSIS_FIFO_BLOCKS);
+    timeline.prepare(inputSampleRate);
+    numSamplesPushed = 0;
+    numSamplesFramed = 0;
+    profiler.reset();
+    scheduler.prepare(analysisSampleRate / hopSize);
+    governor.prepare(1000.0 * hopSize / analysisSampleRate);
+    // Features describe the centre of their frame, which lags the newest sample by half a frame and the decimation filter
+    latencySamples = roundToInt((frameSize - 1) * 0.5 * factor + decimator.getLatency());
+    framer.prepare(NUMBER_OF_CHANNELS, frameSize, hopSize);
+    inputBuffer.setSize(1, hopSize * factor);
+    decimatedBuffer.setSize(1, decimator.getMaxNumOutputSamples(hopSize * factor));
+
+    // The bands are analysed separately and never summed, so no phase compensation is needed
+    crossover.setPhaseCompensation(false);
+    crossover.prepare(sampleRate, decimatedBuffer.getNumSamples(), 1);
+    bandBuffer.setSize(MAX_NUMBER_OF_BANDS, decimatedBuffer.getNumSamples());
+
+    // Create algorithms
+    standard::AlgorithmFactory& factory = standard::AlgorithmFactory::instance();
+
+    aWindowing.reset(factory.create("Windowing", "type", "blackmanharris62"));
+    aSpectrum.reset(factory.create("Spectrum"));
+    aMFCC.reset(factory.create("MFCC"));
+    aSpectralCentroid.reset(factory.create("SpectralCentroidTime", "sampleRate", sampleRate));
+    aLoudness.reset(factory.create("Loudness"));
+    aOnsetDetection.reset(factory.create("OnsetDetection", "method", "hfc", "sampleRate", sampleRate));
+    aSpectralPeaks.reset(factory.create("SpectralPeaks", "sampleRate", sampleRate));
+    aDissonance.reset(factory.create("Dissonance"));
+    aMelBands.reset(factory.create("MelBands", "inputSize", frameSize / 2 + 1, "sampleRate", sampleRate, "numberBands", NUMBER_OF_MEL_BANDS));
+
+    // Currently unused algorithms
+    // aHPCP.reset(factory.create("HPCP", "sampleRate", sampleRate, "nonLinear", true));
+    // aChordsDetection.reset(factory.create("ChordsDetection", "sampleRate", sampleRate, "windowSize", 1));
+
+    // Connect algorithms
+    aWindowing->input("frame").set(eGlobalAudioBuffer);
+    aWindowing->output("frame").set(windowedFrame);
+    aSpectrum->input("frame").set(windowedFrame);
+    aSpectrum->output("spectrum").set(eSpectrumData);
+
+    aMelBands->input("spectrum").set(eSpectrumData);
+    aMelBands->output("bands").set(eMelBands);
+
+    // Published spectrum and mel bands
+    spectrumReducer.prepare(frameSize / 2 + 1, sampleRate, SPECTRUM_PUBLISH_BINS, SPECTRUM_PUBLISH_MIN_FREQUENCY);
+
+    // Start over with an empty frame
+    currentFrame = FeatureFrame();
+    publishedFrame.write(currentFrame);
+    frameCounter.store(0);
+
+    // Pitch detection, on the frame itself like Essentia's PitchYin
+    pitchTracker.prepare(sampleRate, frameSize);
+
+    // Spectral centroid
+    aSpectralCentroid->input("array").set(eGlobalAudioBuffer);
+    aSpectralCentroid->output("centroid").set(eSpectralCentroid);
+
+    // Loudness
+    aLoudness->input("signal").set(eGlobalAudioBuffer);
+    aLoudness->output("loudness").set(eLoudness);
+
+    // Onset detection
+    aOnsetDetection->input("spectrum").set(eSpectrumData);
+    aOnsetDetection->input("phase").set(dummyPhase);
+    aOnsetDetection->output("onsetDetection").set(eOnsetDetection);
+
+    // Spectral peaks
+    aSpectralPeaks->input("spectrum").set(eSpectrumData);
+    aSpectralPeaks->output("frequencies").set(eSpectralPeaksFrequencies);
+    aSpectralPeaks->output("magnitudes").set(eSpectralPeaksMagnitudes);
+
+    aDissonance->input("frequencies").set(eSpectralPeaksFrequencies);
+    aDissonance->input("magnitudes").set(eSpectralPeaksMagnitudes);
+    aDissonance->output("dissonance").set(eDissonance);
+
+    // Currently unused
+    // Harmonic Pitch Class Profile
+    // aHPCP->input("frequencies").set(eSpectralPeaksFrequencies);
+    // aHPCP->input("magnitudes").set(eSpectralPeaksMagnitudes);
+    // aHPCP->output("hpcp").set(eHPCP);
+
+    // Chord detection
+    // aChordsDetection->input("pcp").set(eChordDetectionInput);
+    // aChordsDetection->output("chords").set(eChords);
+    // aChordsDetection->output("strength").set(eChordsStrengths);
+    // End Currently unused
+}
+
+void AnalysisWorker::pushSamples(const float* leftData, const float* rightData, int numSamples, Source source, int64 hostSamplePosition, double timeMs) {
+    // Gains applied to the left and right channel to derive the source signal
+    const auto sqrtHalf = static_cast<float>(SQRT_2_OVER_2);
+    float leftGain = 1.0f;
+    float rightGain = 0.0f;
+    const float* primaryData = leftData;
+
+    switch (source){
+        case LEFT:  break;
+        case RIGHT: primaryData = rightData; break;
+        case MONO:  leftGain = 0.5f;     rightGain = 0.5f;      break;
+        case MID:   leftGain = sqrtHalf; rightGain = sqrtHalf;  break;
+        case SIDE:  leftGain = sqrtHalf; rightGain = -sqrtHalf; break;
+    }
+
+    // If the worker falls behind, the samples that don't fit are dropped instead of blocking the audio thread
+    // The anchor is added first, so the worker can map the samples as soon as they are ready
+    timeline.addAnchor(numSamplesPushed, hostSamplePosition, timeMs);
+    numSamplesPushed += fifo.push(&primaryData, &rightData, numSamples, leftGain, rightGain);
+    notify();
+}
+
+void AnalysisWorker::setCrossoverFrequencies(const float* frequencies, int numCrossovers) {
+    crossover.setCrossoverFrequencies(frequencies, numCrossovers);
+}
+
+void AnalysisWorker::run() {
+    // Features are computed at their scheduled rates and load is shed if the analysis can't keep up with realtime
+    scheduler.setEnabled(true);
+    governor.setEnabled(true);
+    while (!threadShouldExit()){
+        // Sleep until the audio thread signals new samples
+        wait(ANALYSIS_THREAD_WAIT_TIMEOUT_MS);
+        processPendingSamples();
+    }
+}
+
+void AnalysisWorker::analyse(const float* leftData, const float* rightData, int numSamples, Source source) {
+    jassert(!isThreadRunning());
+    // Offline there's no realtime budget, every feature is computed every frame
+    scheduler.setEnabled(false);
+    governor.setEnabled(false);
+
+    // Same path as in realtime: the FIFO is drained after every block, so it never drops samples
+    // The sample count serves as the host position and clock
+    for (int startSample = 0; startSample < numSamples; startSample += maximumBlockSize){
+        const auto blockSize = jmin(maximumBlockSize, numSamples - startSample);
+        const auto timeMs = 1000.0 * static_cast<double>(numSamplesPushed) / inputSampleRate;
+        pushSamples(leftData + startSample, rightData + startSample, blockSize, source, numSamplesPushed, timeMs);
+        processPendingSamples();
+    }
+}
+
+void AnalysisWorker::processPendingSamples() {
+    float* destinations[NUMBER_OF_CHANNELS] = { eGlobalAudioBuffer.data() };
+    const float* sources[NUMBER_OF_CHANNELS] = { decimatedBuffer.getReadPointer(0) };
+    for (int band = 0; band < MAX_NUMBER_OF_BANDS; band++){
+        destinations[FIRST_BAND + band] = bandGraphs[band].getAudioBuffer().data();
+        sources[FIRST_BAND + band] = bandBuffer.getReadPointer(band);
+    }
+
+    // Decimate everything that is ready, move it into the framer and analyse each completed frame
+    while (!threadShouldExit() && fifo.getNumReady() > 0){
+        const auto numInputSamples = fifo.pop(inputBuffer.getArrayOfWritePointers(), jmin(fifo.getNumReady(), inputBuffer.getNumSamples()));
+
+        int numSamples;
+        {
+            ScopedAnalysisTimer timer(profiler.getStage(AnalysisProfiler::DECIMATION));
+            numSamples = decimator.process(inputBuffer.getArrayOfReadPointers(), decimatedBuffer.getArrayOfWritePointers(), numInputSamples, 1);
+        }
+
+        // Apply queued crossover changes, the bands and their count stay the same until the next block
+        crossover.applyPendingChanges();
+
+        // Split into the bands in use at the analysis sample rate, so the cost grows linearly with the band count
+        const auto numBands = crossover.getNumBands();
+        const auto numChannels = numBands > 1 ? FIRST_BAND + numBands : FIRST_BAND;
+        if(numBands > 1){
+            ScopedAnalysisTimer timer(profiler.getStage(AnalysisProfiler::BAND_SPLITTING));
+            AudioBuffer<float> decimatedBlock(decimatedBuffer.getArrayOfWritePointers(), 1, numSamples);
+            crossover.process(decimatedBlock, bandBuffer, numSamples);
+        }
+
+        int position = 0;
+        while (position < numSamples){
+            const auto numFramed = framer.write(sources, position, numSamples - position, numChannels);
+            position += numFramed;
+            numSamplesFramed += numFramed;
+
+            if(framer.isFrameReady()){
+                framer.readFrame(destinations, numChannels);
+                updateFrameTime();
+
+                const auto frameStart = Time::getHighResolutionTicks();
+                {
+                    ScopedAnalysisTimer timer(profiler.getStage(AnalysisProfiler::FRAME));
+                    computeGlobalFeatures();
+                    computeSubBandFeatures(numBands);
+                    publishFrame(numBands);
+                }
+                governor.frameAnalysed(Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - frameStart) * 1000.0);
+                frameNotifier.notify();
+            }
+        }
+    }
+}
+
+void AnalysisWorker::computeGlobalFeatures() {
+    // Essentia algorithms compute routines
+    computeTimed(*aWindowing, AnalysisProfiler::WINDOWING);
+    computeTimed(*aSpectrum, AnalysisProfiler::SPECTRUM);
+
+    // Every feature runs at its scheduled rate and keeps its previous results in between
+    if(isDue(AnalysisScheduler::LOUDNESS)){
+        computeTimed(*aLoudness, AnalysisProfiler::LOUDNESS);
+    }
+    if(isDue(AnalysisScheduler::ONSET_DETECTION)){
+        computeTimed(*aOnsetDetection, AnalysisProfiler::ONSET_DETECTION);
+    }
+    if(isDue(AnalysisScheduler::SPECTRAL_CENTROID)){
+        computeTimed(*aSpectralCentroid, AnalysisProfiler::SPECTRAL_CENTROID);
+    }
+    if(isDue(AnalysisScheduler::MEL_BANDS)){
+        computeTimed(*aMelBands, AnalysisProfiler::MEL_BANDS);
+    }
+    if(isDue(AnalysisScheduler::PITCH)){
+        ScopedAnalysisTimer timer(profiler.getStage(AnalysisProfiler::PITCH_YIN));
+        pitchTracker.process(eGlobalAudioBuffer, ePitchYIN, ePitchConfidence);
+    }
+    if(isDue(AnalysisScheduler::DISSONANCE)){
+        computeTimed(*aSpectralPeaks, AnalysisProfiler::SPECTRAL_PEAKS);
+        computeTimed(*aDissonance, AnalysisProfiler::DISSONANCE);
+    }
+    // aHPCP->compute();
+
+    // Chord detection (currently not in use)
+    /*
+    eChordDetectionInput.emplace_back(eHPCP);
+    if(eChordDetectionInput.size() > 2){
+        aChordsDetection->compute();
+
+        int strongestChordIdx = std::distance(eChordsStrengths.begin(), std::max_element(eChordsStrengths.begin(), eChordsStrengths.end()));
+        eStrongestChord = eChords[strongestChordIdx];
+
+        eChords.clear();
+        eChordsStrengths.clear();
+        eChordDetectionInput.clear();
+    }
+    */
+
+    // Collect results
+    currentFrame.spectralCentroid = eSpectralCentroid;
+    currentFrame.pitchYIN = ePitchYIN;
+    currentFrame.pitchConfidence = ePitchConfidence;
+    currentFrame.loudness = eLoudness;
+    currentFrame.onsetDetection = eOnsetDetection;
+    currentFrame.dissonance = eDissonance;
+    spectrumReducer.process(eSpectrumData, currentFrame.spectrum.data());
+    const auto numMelBands = jmin(NUMBER_OF_MEL_BANDS, static_cast<int>(eMelBands.size()));
+    std::copy(eMelBands.begin(), eMelBands.begin() + numMelBands, currentFrame.melBands.begin());
+
+    currentFrame.analysisLoad = governor.getLoad();
+    currentFrame.sheddingLevel = governor.getLevel();
+    for (int feature = 0; feature < AnalysisScheduler::NUMBER_OF_FEATURES; feature++){
+        currentFrame.featureRates[feature] = scheduler.getRate(static_cast<AnalysisScheduler::Feature>(feature), governor.getLevel());
+    }
+}
+
+bool AnalysisWorker::isDue(AnalysisScheduler::Feature feature) const {
+    // The frame number is only incremented when the frame is published
+    return scheduler.shouldCompute(feature, currentFrame.frameNumber + 1, governor.getLevel());
+}
+
+void AnalysisWorker::publishFrame(int numBands) {
+    // Slots of bands that are not in use were not computed, so their values are stale
+    for (int band = 0; band < MAX_NUMBER_OF_BANDS; band++){
+        for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++){
+            const auto index = FeatureFrame::getSlotIndex(band, slot);
+            const auto inUse = numBands > 1 && band < numBands && slot < static_cast<int>(bandSlots[band].size());
+            currentFrame.slotActive[index] = inUse && bandSlots[band][slot]->getCurrentValue(currentFrame.slotValues[index]);
+        }
+    }
+
+    currentFrame.frameNumber++;
+    publishedFrame.write(currentFrame);
+    frameCounter.store(currentFrame.frameNumber);
+}
+
+void AnalysisWorker::computeSubBandFeatures(int numBands) {
+    // Sub-band features are only computed if more than 1 band is selected
+    if(numBands == 1){
+        return;
+    }
+
+    for (int band = 0; band < numBands; band++){
+        computeBand(band);
+    }
+}
+
+void AnalysisWorker::computeBand(int band) {
+    auto& bandGraph = bandGraphs[band];
+    auto& slots = bandSlots[band];
+    // One window + FFT per band and frame, no matter how many slots consume it
+    // The first slot whose active algorithm reads the spectrum computes it (see FeatureSlotProcessor::compute())
+    bandGraph.startNewFrame();
+
+    for (int slot = 0; slot < static_cast<int>(slots.size()); slot++){
+        ScopedAnalysisTimer timer(profiler.getSlot(band, slot));
+        slots[slot]->compute();
+    }
+}
+
+void AnalysisWorker::computeTimed(Algorithm& algorithm, AnalysisProfiler::Stage stage) {
+    ScopedAnalysisTimer timer(profiler.getStage(stage));
+    algorithm.compute();
+}
+
+double AnalysisWorker::getAnalysisSampleRate() const {
+    return analysisSampleRate;
+}
+
+void AnalysisWorker::readFeatureFrame(FeatureFrame& frame) const {
+    publishedFrame.read(frame);
+}
+
+void AnalysisWorker::updateFrameTime() {
+    // Decimated sample n is computed once input sample (n + 1) * factor - 1 has arrived and is delayed by the filter
+    const auto factor = decimator.getFactor();
+    const auto frameCentre = static_cast<double>(numSamplesFramed) - framer.getFrameSize() * 0.5;
+    const auto streamSample = (frameCentre + 0.5) * factor - 1.0 - decimator.getLatency();
+
+    double hostSample;
+    timeline.lookUp(streamSample, hostSample, currentFrame.timeMs);
+    currentFrame.hostSamplePosition = static_cast<int64>(std::round(hostSample));
+}
+
+int AnalysisWorker::getLatencySamples() const {
+    return latencySamples.load();
+}
+
+AnalysisFrameNotifier& AnalysisWorker::getFrameNotifier() {
+    return frameNotifier;
+}
+
+const AnalysisProfiler& AnalysisWorker::getProfiler() const {
+    return profiler;
+}
+
+uint32 AnalysisWorker::getFrameCounter() const {
+    return frameCounter.load();
+}
+
+BandAnalysisGraph &AnalysisWorker::getBandGraph(int band) {
+    return bandGraphs[band];
+}
@@ -0,0 +1,244 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_ANALYSISWORKER_H
+#define MUSIC_VIS_BACKEND_ANALYSISWORKER_H
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../external_libraries/essentia/include/algorithmfactory.h"
+#include "../FeatureSlot/FeatureSlotProcessor.h"
+#include "../Constants.h"
+#include "AnalysisFifo.h"
+#include "AnalysisFramer.h"
+#include "AnalysisDecimator.h"
+#include "AnalysisTimeline.h"
+#include "AnalysisFrameNotifier.h"
+#include "AnalysisProfiler.h"
+#include "AnalysisGovernor.h"
+#include "AnalysisScheduler.h"
+#include "FeatureFrame.h"
+#include "SeqLock.h"
+#include "BandAnalysisGraph.h"
+#include "LinkwitzRileyCrossover.h"
+#include "LogSpectrumReducer.h"
+#include "YinPitchTracker.h"
+
+using namespace std;
+using namespace juce;
+using namespace essentia;
+using namespace essentia::standard;
+
+/**
+ * Dedicated analysis thread.
+ * The audio thread hands its samples over via pushSamples(), which only copies them into a lock-free FIFO.
+ * The worker owns all Essentia algorithms, drains the FIFO, decimates the samples to the analysis sample rate
+ * (ANALYSIS_TARGET_SAMPLE_RATE), splits them into sub-bands, feeds them into a framer and, for every frame of frameSize samples
+ * (a new one every hopSize samples), computes the global features and the sub-band FeatureSlots, publishes
+ * the results and notifies the consumers registered with getFrameNotifier(). Feature resolution is therefore
+ * independent of the host's block size and the CPU cost does not grow with the host's sample rate.
+ */
+class AnalysisWorker : public Thread {
+public:
+    /**
+     * Enum for the channels of the analysis frames
+     */
+    enum Channel {
+        GLOBAL = 0,
+        FIRST_BAND, // Sub-band b is at channel FIRST_BAND + b
+        NUMBER_OF_CHANNELS = FIRST_BAND + MAX_NUMBER_OF_BANDS
+    };
+
+    explicit AnalysisWorker(vector<vector<unique_ptr<FeatureSlotProcessor>>>& bandSlots);
+    ~AnalysisWorker() override;
+
+    /**
+     * (Re)create the Essentia algorithms and allocate all buffers. Must be called while the thread is stopped.
+     * @param sampleRate System's current sample rate
+     * @param maximumBlockSize Maximum number of samples the host passes per block
+     * @param frameSize Number of samples analysed per computation (at the analysis sample rate)
+     * @param hopSize Number of samples between two consecutive analysis frames (at the analysis sample rate)
+     */
+    void prepare(double sampleRate, int maximumBlockSize, int frameSize, int hopSize);
+
+    /**
+     * Enum for the signal that is analysed, derived from the left and right input channels
+     */
+    enum Source {
+        LEFT = 0,
+        RIGHT,
+        MONO,   // (L + R) / 2
+        MID,    // (L + R) / sqrt(2)
+        SIDE    // (L - R) / sqrt(2)
+    };
+
+    /**
+     * Hand samples over to the worker. Called from the audio thread: only copies into the FIFO and wakes the worker.
+     * The analysed source signal is mixed from the left and right channels during that copy.
+     * @param leftData Left input
+     * @param rightData Right input (equal to leftData for mono inputs)
+     * @param numSamples Number of samples
+     * @param source The signal to analyse
+     * @param hostSamplePosition Host sample position of the first sample
+     * @param timeMs Time at which the block is processed (Time::getMillisecondCounterHiRes())
+     */
+    void pushSamples(const float* leftData, const float* rightData, int numSamples, Source source, int64 hostSamplePosition, double timeMs);
+
+    /**
+     * Update the sub-band crossovers of the analysis. Must not be called on the audio or worker thread.
+     * The change is queued and applied by the worker between two blocks of at most one hop, never during a frame.
+     * @param frequencies Ascending crossover frequencies, one less than the number of bands
+     * @param numCrossovers Number of crossover frequencies, 0 disables the sub-band analysis
+     */
+    void setCrossoverFrequencies(const float* frequencies, int numCrossovers);
+
+    void run() override;
+
+    /**
+     * Analyse samples synchronously on the calling thread, e.g. to render features of a file faster than realtime.
+     * Runs exactly the same chain as the worker thread and notifies the listeners of getFrameNotifier() for every
+     * frame. Must only be called while the thread is stopped. The host position is the number of samples analysed
+     * since prepare().
+     * @param leftData Left input
+     * @param rightData Right input (equal to leftData for mono inputs)
+     * @param numSamples Number of samples, any length
+     * @param source The signal to analyse
+     */
+    void analyse(const float* leftData, const float* rightData, int numSamples, Source source);
+
+    // Sample rate of the analysis frames after decimation
+    double getAnalysisSampleRate() const;
+
+    /**
+     * Copy the results of the most recently analysed frame. Lock-free and callable from any thread, the copy is always
+     * consistent and never delays the worker.
+     * @param frame Set to the most recent results
+     */
+    void readFeatureFrame(FeatureFrame& frame) const;
+
+    // Number of the most recently published frame, a cheap check whether readFeatureFrame() would return new results
+    uint32 getFrameCounter() const;
+
+    // Host samples between the centre of a frame and its newest sample, i.e. the delay before a feature is available
+    int getLatencySamples() const;
+
+    // Shared input (time-domain frame and spectrum) for the FeatureSlots of a sub-band
+    BandAnalysisGraph& getBandGraph(int band);
+
+    // Notifies its listeners on the analysis thread whenever the results of a new frame are published
+    AnalysisFrameNotifier& getFrameNotifier();
+
+    // Timings of the analysis stages and FeatureSlots, readable from any thread
+    const AnalysisProfiler& getProfiler() const;
+
+private:
+    // Decimate, split, frame and analyse all samples in the FIFO
+    void processPendingSamples();
+    // Run the global Essentia algorithms on the current frame
+    void computeGlobalFeatures();
+    // Collect the results of the current frame and publish them as a whole
+    void publishFrame(int numBands);
+    // Run the FeatureSlots of the first numBands sub-bands on the current frame (none if numBands is 1)
+    void computeSubBandFeatures(int numBands);
+    // Compute the band's spectrum once if any slot needs it, then run all of the band's slots
+    void computeBand(int band);
+    // Run an Essentia algorithm and record its duration
+    void computeTimed(Algorithm& algorithm, AnalysisProfiler::Stage stage);
+
+    // Samples from the audio thread
+    AnalysisFifo fifo;
+    double inputSampleRate = 0.0;
+    int maximumBlockSize = 0;
+    // Host positions and times of the samples in the FIFO
+    AnalysisTimeline timeline;
+    // Samples pushed into the FIFO so far (audio thread)
+    int64 numSamplesPushed = 0;
+    // Decimated samples written to the framer so far (worker thread)
+    int64 numSamplesFramed = 0;
+    // Look up the host position and time of the current frame before its features are computed
+    void updateFrameTime();
+    atomic<int> latencySamples { 0 };
+    // Brings the input down to the analysis sample rate
+    AnalysisDecimator decimator;
+    double analysisSampleRate = 0.0;
+    // Splits the decimated samples into overlapping analysis frames
+    AnalysisFramer framer;
+    // Samples moved from the FIFO to the decimator, at most one hop (after decimation) at a time
+    AudioBuffer<float> inputBuffer;
+    // Decimated samples on their way into the framer
+    AudioBuffer<float> decimatedBuffer;
+    // Splits the decimated samples into sub-bands, at the analysis sample rate
+    LinkwitzRileyCrossover crossover;
+    // Sub-bands of the decimated samples, one channel per band
+    AudioBuffer<float> bandBuffer;
+
+    // References to the sub-band FeatureSlots owned by the processor, one vector per band
+    vector<vector<unique_ptr<FeatureSlotProcessor>>>& bandSlots;
+
+    // Values estimated by Essentia are marked with an "e" prefix
+    // Will contain copy of the global JUCE audio buffer (not subdivided into bands)
+    // This buffer is used in the calculation of global audio features
+    vector<Real> eGlobalAudioBuffer;
+    // Sub-band frames and spectra, indexed by band
+    array<BandAnalysisGraph, MAX_NUMBER_OF_BANDS> bandGraphs;
+
+    // Will contain JUCE audio buffer after windowing
+    vector<Real> windowedFrame;
+    // Will contain the spectrum data
+    vector<Real> eSpectrumData;
+    vector<Real> eMelBands;
+    Real eSpectralCentroid = 0.0f;
+    Real ePitchYIN = 0.0f;
+    Real ePitchConfidence = 0.0f;
+    Real eLoudness = 0.0f;
+    Real eOnsetDetection = 0.0f;
+    vector<Real> eSpectralPeaksFrequencies; // in Hz
+    vector<Real> eSpectralPeaksMagnitudes;
+    vector<Real> eHPCP; // Default size := 12
+    vector<vector<Real>> eChordDetectionInput;
+    vector<string> eChords;
+    vector<Real> eChordsStrengths;
+    string eStrongestChord = ""; // for displaying the best candidate in chord detection
+    Real eDissonance = 0.0f;
+    // Dummy phase vector necessary as essentia algorithms must be initialised with all fields set to something
+    // Phase would only be used in the complex ODF, so we can use an empty vector here
+    vector<Real> dummyPhase;
+
+    // Results of the current frame, only accessed by the worker
+    FeatureFrame currentFrame;
+    // Global pitch and confidence, FFT-based YIN
+    YinPitchTracker pitchTracker;
+    // Reduces the spectrum to the published log-spaced bins
+    LogSpectrumReducer spectrumReducer;
+    // Results of the most recent complete frame, read by the processor and the publisher
+    SeqLock<FeatureFrame> publishedFrame;
+    atomic<uint32> frameCounter { 0 };
+    AnalysisFrameNotifier frameNotifier;
+    AnalysisProfiler profiler;
+    // Decides in which frames each global feature is computed
+    AnalysisScheduler scheduler;
+    // Lowers the rate of expensive features if the analysis exceeds its time budget
+    AnalysisGovernor governor;
+    // Whether the feature is due in the current frame
+    bool isDue(AnalysisScheduler::Feature feature) const;
+
+    // Essentia algorithms are marked by an "a" prefix
+    unique_ptr<Algorithm> aWindowing;
+    unique_ptr<Algorithm> aSpectrum;
+    unique_ptr<Algorithm> aSpectralCentroid;
+    unique_ptr<Algorithm> aLoudness;
+    unique_ptr<Algorithm> aOnsetDetection;
+    unique_ptr<Algorithm> aSpectralPeaks;
+    unique_ptr<Algorithm> aChordsDetection;
+    unique_ptr<Algorithm> aDissonance; // Outputs sensory dissonance on a scale from 0 (consonant) to 1 (dissonant)
+    unique_ptr<Algorithm> aMFCC;
+    unique_ptr<Algorithm> aMelBands;
+
+    // Currently unused algorithms
+    // unique_ptr<Algorithm> aHPCP; // Harmonic Pitch Class Profile
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisWorker)
+};
+
+
+#endif //MUSIC_VIS_BACKEND_ANALYSISWORKER_H
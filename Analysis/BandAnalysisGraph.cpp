@@ -0,0 +1,52 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "BandAnalysisGraph.h"
+
+void BandAnalysisGraph::prepare(int frameSize) {
+    audioBuffer.assign(frameSize, 0.0f);
+    windowedFrame.assign(frameSize, 0.0f);
+    spectrum.assign(frameSize / 2 + 1, 0.0f);
+    isSpectrumUpToDate = false;
+
+    standard::AlgorithmFactory& factory = standard::AlgorithmFactory::instance();
+    aWindowing.reset(factory.create("Windowing", "type", "blackmanharris62"));
+    aSpectrum.reset(factory.create("Spectrum", "size", frameSize));
+
+    aWindowing->input("frame").set(audioBuffer);
+    aWindowing->output("frame").set(windowedFrame);
+    aSpectrum->input("frame").set(windowedFrame);
+    aSpectrum->output("spectrum").set(spectrum);
+}
+
+void BandAnalysisGraph::ensureSpectrum() {
+    if(isSpectrumUpToDate){
+        return;
+    }
+
+    const auto start = Time::getHighResolutionTicks();
+    aWindowing->compute();
+    aSpectrum->compute();
+    isSpectrumUpToDate = true;
+
+    if(spectrumTiming != nullptr){
+        spectrumTiming->record(1.0e6 * Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start));
+    }
+}
+
+void BandAnalysisGraph::setSpectrumTiming(TimingHistogram* histogram) {
+    spectrumTiming = histogram;
+}
+
+void BandAnalysisGraph::startNewFrame() {
+    isSpectrumUpToDate = false;
+}
+
+vector<Real> &BandAnalysisGraph::getAudioBuffer() {
+    return audioBuffer;
+}
+
+vector<Real> &BandAnalysisGraph::getSpectrum() {
+    return spectrum;
+}
@@ -0,0 +1,65 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_BANDANALYSISGRAPH_H
+#define MUSIC_VIS_BACKEND_BANDANALYSISGRAPH_H
+
+#include <juce_core/juce_core.h>
+#include "../external_libraries/essentia/include/algorithmfactory.h"
+#include "AnalysisProfiler.h"
+
+using namespace std;
+using namespace essentia;
+using namespace essentia::standard;
+
+/**
+ * Shared analysis state of one sub-band.
+ * Holds the band's current time-domain frame and computes its windowed magnitude spectrum at most once per frame.
+ * All FeatureSlots of the band read from these two buffers, so the cost of the FFT does not grow with the number
+ * of slots that consume the spectrum. The spectrum is computed on demand by the first slot whose algorithm reads it.
+ */
+class BandAnalysisGraph {
+public:
+    /**
+     * (Re)create the windowing and spectrum algorithms and allocate the frame buffer
+     * @param frameSize Number of samples per analysis frame
+     */
+    void prepare(int frameSize);
+
+    /**
+     * Compute window and FFT of the current frame, unless that already happened for this frame
+     */
+    void ensureSpectrum();
+
+    /**
+     * Record the time ensureSpectrum() takes to compute a spectrum
+     * @param histogram Histogram to record to, nullptr to stop recording
+     */
+    void setSpectrumTiming(TimingHistogram* histogram);
+
+    /**
+     * Mark the current frame as consumed. Called after a new frame was written into the audio buffer.
+     */
+    void startNewFrame();
+
+    // Time-domain frame of this band
+    vector<Real>& getAudioBuffer();
+    // Magnitude spectrum of the current frame (only valid after ensureSpectrum())
+    vector<Real>& getSpectrum();
+
+private:
+    vector<Real> audioBuffer;
+    vector<Real> windowedFrame;
+    vector<Real> spectrum;
+
+    // Whether the spectrum has been computed for the current frame
+    bool isSpectrumUpToDate = false;
+    TimingHistogram* spectrumTiming = nullptr;
+
+    unique_ptr<Algorithm> aWindowing;
+    unique_ptr<Algorithm> aSpectrum;
+};
+
+
+#endif //MUSIC_VIS_BACKEND_BANDANALYSISGRAPH_H
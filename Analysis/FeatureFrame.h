@@ -0,0 +1,56 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_FEATUREFRAME_H
+#define MUSIC_VIS_BACKEND_FEATUREFRAME_H
+
+#include <array>
+#include <juce_core/juce_core.h>
+#include "../Constants.h"
+#include "AnalysisScheduler.h"
+
+using namespace std;
+using namespace juce;
+
+/**
+ * All results of one analysis frame. The worker publishes it as a whole (see SeqLock), so consumers always see the
+ * scalar and vector features of the same frame together.
+ */
+struct FeatureFrame {
+    // Number of the frame since the worker was prepared, 0 if no frame has been analysed yet
+    uint32 frameNumber = 0;
+    // Host sample position of the centre of the frame, which the features describe
+    int64 hostSamplePosition = 0;
+    // Time at which the audio at the centre of the frame was processed (Time::getMillisecondCounterHiRes())
+    double timeMs = 0.0;
+
+    // Global features
+    float spectralCentroid = 0.0f;
+    float pitchYIN = 0.0f;
+    float pitchConfidence = 0.0f;
+    float loudness = 0.0f;
+    float onsetDetection = 0.0f;
+    float dissonance = 0.0f;
+    // Logarithmically spaced spectrum (see LogSpectrumReducer)
+    array<float, SPECTRUM_PUBLISH_BINS> spectrum {};
+    array<float, NUMBER_OF_MEL_BANDS> melBands {};
+
+    // FeatureSlot results, slot s of band b is at getSlotIndex(b, s)
+    array<float, MAX_NUMBER_OF_BANDS * NUMBER_OF_SLOTS> slotValues {};
+    // Whether the slot had an algorithm selected
+    array<bool, MAX_NUMBER_OF_BANDS * NUMBER_OF_SLOTS> slotActive {};
+
+    // Load of the analysis thread and the governor's shedding level (0 = every feature at its scheduled rate)
+    float analysisLoad = 0.0f;
+    int sheddingLevel = 0;
+    // Update rate in Hz of each AnalysisScheduler::Feature, in between the features hold their previous value
+    array<float, AnalysisScheduler::NUMBER_OF_FEATURES> featureRates {};
+
+    static int getSlotIndex(int band, int slot) {
+        return band * NUMBER_OF_SLOTS + slot;
+    }
+};
+
+
+#endif //MUSIC_VIS_BACKEND_FEATUREFRAME_H
@@ -0,0 +1,209 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "LinkwitzRileyCrossover.h"
+
+void LinkwitzRileyCrossover::prepare(double newSampleRate, int newMaximumBlockSize, int newNumChannels) {
+    jassert(newNumChannels <= static_cast<int>(SIMDFloat::size()));
+
+    sampleRate = newSampleRate;
+    maximumBlockSize = newMaximumBlockSize;
+    numChannels = jmin(newNumChannels, static_cast<int>(SIMDFloat::size()));
+
+    // Storage for all bands in one contiguous block, unused lanes stay at zero
+    interleavedBands.assign(static_cast<size_t>(MAX_NUMBER_OF_BANDS * maximumBlockSize), SIMDFloat::expand(0.0f));
+
+    // Nothing is processed, so the active set can be recalculated for the new sample rate in place. It already holds
+    // the latest frequencies, a set that is still waiting would be for the old sample rate.
+    calculateCoefficients(coefficientSets[activeSet]);
+    applyCoefficients(coefficientSets[activeSet]);
+    handoverSet.fetch_and(~NEW_SET_FLAG);
+    releaseUnusedCoefficients();
+    reset();
+}
+
+void LinkwitzRileyCrossover::reset() {
+    for (int k = 0; k < MAX_NUMBER_OF_BANDS - 1; k++){
+        for (auto& filter : lowpasses[k]){
+            filter.reset();
+        }
+        for (auto& filter : highpasses[k]){
+            filter.reset();
+        }
+        for (auto& filter : allpasses[k]){
+            filter.reset();
+        }
+    }
+}
+
+void LinkwitzRileyCrossover::setCrossoverFrequencies(const float* frequencies, int newNumCrossovers) {
+    jassert(newNumCrossovers < MAX_NUMBER_OF_BANDS);
+    newNumCrossovers = jlimit(0, MAX_NUMBER_OF_BANDS - 1, newNumCrossovers);
+
+    // A crossover must not be below the previous one, otherwise the bands overlap
+    float previous = 0.0f;
+    for (int k = 0; k < newNumCrossovers; k++){
+        crossoverFrequencies[k] = jmax(previous, frequencies[k]);
+        previous = crossoverFrequencies[k];
+    }
+    requestedNumCrossovers = newNumCrossovers;
+
+    // The set handed back is not used by any filter, a set that wasn't applied yet is simply replaced
+    calculateCoefficients(coefficientSets[writeSet]);
+    writeSet = handoverSet.exchange(writeSet | NEW_SET_FLAG) & ~NEW_SET_FLAG;
+    releaseUnusedCoefficients();
+}
+
+void LinkwitzRileyCrossover::applyPendingChanges() {
+    if((handoverSet.load() & NEW_SET_FLAG) == 0){
+        return;
+    }
+
+    // The old set's coefficients are not freed here: either the old set still references them, or it was already
+    // rewritten and they wait in the release pool until the filters dropped them
+    activeSet = handoverSet.exchange(activeSet) & ~NEW_SET_FLAG;
+    applyCoefficients(coefficientSets[activeSet]);
+}
+
+int LinkwitzRileyCrossover::getNumBands() const {
+    return numCrossovers.load() + 1;
+}
+
+void LinkwitzRileyCrossover::getLogSpacedFrequencies(float lowest, float highest, int numCrossovers, float* frequencies) {
+    for (int k = 0; k < numCrossovers; k++){
+        const auto proportion = numCrossovers > 1 ? static_cast<float>(k) / static_cast<float>(numCrossovers - 1) : 0.0f;
+        frequencies[k] = lowest * pow(highest / lowest, proportion);
+    }
+}
+
+void LinkwitzRileyCrossover::setPhaseCompensation(bool shouldCompensate) {
+    phaseCompensation = shouldCompensate;
+}
+
+void LinkwitzRileyCrossover::calculateCoefficients(CoefficientSet& set) {
+    // Keep the cutoffs below Nyquist
+    const auto maxCutoff = static_cast<float>(sampleRate * 0.49);
+
+    set.numCrossovers = requestedNumCrossovers;
+    for (int k = 0; k < MAX_NUMBER_OF_BANDS - 1; k++){
+        // The filters may still use the old coefficients
+        for (auto* coefficients : { &set.lowpasses[k], &set.highpasses[k], &set.allpasses[k] }){
+            if(*coefficients != nullptr){
+                releasePool.push_back(std::move(*coefficients));
+            }
+        }
+
+        const auto frequency = k < requestedNumCrossovers ? jlimit(1.0f, maxCutoff, crossoverFrequencies[k]) : maxCutoff;
+
+        set.lowpasses[k] = dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, frequency, SQRT_2_OVER_2);
+        set.highpasses[k] = dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, frequency, SQRT_2_OVER_2);
+        // LR4 lowpass + LR4 highpass = 2nd order allpass with Butterworth Q
+        set.allpasses[k] = dsp::IIR::Coefficients<float>::makeAllPass(sampleRate, frequency, SQRT_2_OVER_2);
+    }
+}
+
+void LinkwitzRileyCrossover::releaseUnusedCoefficients() {
+    // Only the pool references coefficients with a count of 1: no filter or set can pick them up again
+    releasePool.erase(remove_if(releasePool.begin(), releasePool.end(), [](const dsp::IIR::Coefficients<float>::Ptr& coefficients){
+        return coefficients->getReferenceCount() <= 1;
+    }), releasePool.end());
+}
+
+void LinkwitzRileyCrossover::applyCoefficients(const CoefficientSet& set) {
+    for (int k = 0; k < MAX_NUMBER_OF_BANDS - 1; k++){
+        for (int i = 0; i < 2; i++){
+            lowpasses[k][i].coefficients = set.lowpasses[k];
+            highpasses[k][i].coefficients = set.highpasses[k];
+        }
+        // The allpass of crossover k compensates all bands below it
+        for (int band = 0; band < k; band++){
+            allpasses[band][k].coefficients = set.allpasses[k];
+        }
+    }
+    numCrossovers.store(set.numCrossovers);
+}
+
+void LinkwitzRileyCrossover::process(const AudioBuffer<float>& input, AudioBuffer<float>& bands, int numSamples) {
+    jassert(numSamples <= maximumBlockSize);
+    applyPendingChanges();
+    const auto channels = jmin(numChannels, input.getNumChannels());
+    const auto crossovers = numCrossovers.load();
+    jassert(bands.getNumChannels() >= (crossovers + 1) * numChannels);
+
+    // The highest band holds the remainder above the crossovers processed so far
+    auto* remainder = interleavedBands.data() + crossovers * maximumBlockSize;
+    interleave(input, remainder, channels, numSamples);
+
+    // Filters that start being used may still hold the state of an earlier signal
+    // Only those are cleared, the bands that were already split continue without a discontinuity
+    for (int k = numProcessedCrossovers; k < crossovers; k++){
+        for (auto& filter : lowpasses[k]){
+            filter.reset();
+        }
+        for (auto& filter : highpasses[k]){
+            filter.reset();
+        }
+        for (int band = 0; band < k; band++){
+            allpasses[band][k].reset();
+        }
+    }
+    numProcessedCrossovers = crossovers;
+
+    // Split off one band per crossover, from the lowest upwards
+    for (int k = 0; k < crossovers; k++){
+        auto* band = interleavedBands.data() + k * maximumBlockSize;
+        for (int i = 0; i < numSamples; i++){
+            band[i] = lowpasses[k][1].processSample(lowpasses[k][0].processSample(remainder[i]));
+            remainder[i] = highpasses[k][1].processSample(highpasses[k][0].processSample(remainder[i]));
+        }
+
+        // Align the phase with the bands split off at the higher crossovers
+        for (int j = k + 1; phaseCompensation && j < crossovers; j++){
+            processFilter(allpasses[k][j], band, numSamples);
+        }
+
+        for (auto& filter : lowpasses[k]){
+            filter.snapToZero();
+        }
+        for (auto& filter : highpasses[k]){
+            filter.snapToZero();
+        }
+    }
+
+    for (int b = 0; b <= crossovers; b++){
+        deinterleave(interleavedBands.data() + b * maximumBlockSize, bands, b * numChannels, channels, numSamples);
+    }
+}
+
+void LinkwitzRileyCrossover::processFilter(Filter& filter, SIMDFloat* samples, int numSamples) {
+    for (int i = 0; i < numSamples; i++){
+        samples[i] = filter.processSample(samples[i]);
+    }
+    filter.snapToZero();
+}
+
+void LinkwitzRileyCrossover::interleave(const AudioBuffer<float>& source, SIMDFloat* dest, int numChannels, int numSamples) {
+    // The registers are laid out contiguously, lane c of sample i is at index i * size + c
+    auto* raw = reinterpret_cast<float*>(dest);
+    const auto stride = SIMDFloat::size();
+
+    for (int channel = 0; channel < numChannels; channel++){
+        auto* reader = source.getReadPointer(channel);
+        for (int i = 0; i < numSamples; i++){
+            raw[i * stride + channel] = reader[i];
+        }
+    }
+}
+
+void LinkwitzRileyCrossover::deinterleave(const SIMDFloat* source, AudioBuffer<float>& dest, int destChannel, int numChannels, int numSamples) {
+    auto* raw = reinterpret_cast<const float*>(source);
+    const auto stride = SIMDFloat::size();
+
+    for (int channel = 0; channel < numChannels; channel++){
+        auto* writer = dest.getWritePointer(destChannel + channel);
+        for (int i = 0; i < numSamples; i++){
+            writer[i] = raw[i * stride + channel];
+        }
+    }
+}
@@ -0,0 +1,153 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_LINKWITZRILEYCROSSOVER_H
+#define MUSIC_VIS_BACKEND_LINKWITZRILEYCROSSOVER_H
+
+#include <juce_dsp/juce_dsp.h>
+#include "../Constants.h"
+
+using namespace std;
+using namespace juce;
+
+/**
+ * Phase-coherent band bank of up to MAX_NUMBER_OF_BANDS bands built from 4th order Linkwitz-Riley (LR4) filters.
+ * The bands are split off one after another, starting with the lowest: band k is the lowpass at crossover k of what
+ * remains above all lower crossovers. Every band is then passed through the allpasses of the crossovers above it,
+ * so all bands sum to a flat (allpass) response. All channels are processed at once: each channel occupies one lane
+ * of a SIMD register, so a stereo signal costs the same as a mono one.
+ *
+ * For 3 bands (LP/HP = LR4 lowpass/highpass, AP = 2nd order allpass):
+ *  low  = AP(crossover 2) <- LP(crossover 1)
+ *  mid  = LP(crossover 2) <- HP(crossover 1)
+ *  high = HP(crossover 2) <- HP(crossover 1)
+ *
+ * New crossover frequencies are turned into a complete set of coefficients on the calling thread and handed to the
+ * processing thread through a triple buffer, which applies it before its next block. A set is only rewritten after the
+ * processing thread handed it back, so the filters never use coefficients that are being written. Coefficients
+ * replaced in a set are kept in a release pool until no filter references them anymore, so they are always freed on
+ * the calling thread, never on the processing thread.
+ */
+class LinkwitzRileyCrossover {
+public:
+    using SIMDFloat = dsp::SIMDRegister<float>;
+
+    /**
+     * Allocate the interleaved buffers, apply the current frequencies and reset the filters.
+     * Must not be called while process() is running.
+     * @param sampleRate Sample rate of the signal to split
+     * @param maximumBlockSize Maximum number of samples per call to process()
+     * @param numChannels Number of channels, at most SIMDFloat::size()
+     */
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+
+    // Clear the filter states
+    void reset();
+
+    /**
+     * Update the number of bands and the crossover frequencies.
+     * Coefficients are recalculated and allocated, so this must not be called on the processing thread, and only ever
+     * from one thread. The change takes effect at the start of the next block (see applyPendingChanges()).
+     * @param frequencies Ascending crossover frequencies, one less than the number of bands
+     * @param numCrossovers Number of crossover frequencies, at most MAX_NUMBER_OF_BANDS - 1
+     */
+    void setCrossoverFrequencies(const float* frequencies, int numCrossovers);
+
+    /**
+     * Apply the most recent coefficients handed over by setCrossoverFrequencies(), if any.
+     * Called by the processing thread before a block, process() does so as well.
+     */
+    void applyPendingChanges();
+
+    // Number of bands process() currently produces
+    int getNumBands() const;
+
+    /**
+     * Crossover frequencies from the lowest to the highest, those in between evenly spaced on a logarithmic scale
+     * @param lowest Frequency of the lowest crossover
+     * @param highest Frequency of the highest crossover
+     * @param numCrossovers Number of crossovers
+     * @param frequencies Destination for numCrossovers frequencies
+     */
+    static void getLogSpacedFrequencies(float lowest, float highest, int numCrossovers, float* frequencies);
+
+    /**
+     * Enable or disable the allpass phase compensation (enabled by default). The compensation is only needed if the
+     * bands are summed again, without it the cost grows linearly instead of quadratically with the number of bands.
+     * Must not be called while process() is running.
+     */
+    void setPhaseCompensation(bool shouldCompensate);
+
+    /**
+     * Split the input into bands
+     * @param input Input signal
+     * @param bands Output, channel c of band b is written to channel b * numChannels + c (numChannels as prepared)
+     * @param numSamples Number of samples to process, at most the prepared maximum block size
+     */
+    void process(const AudioBuffer<float>& input, AudioBuffer<float>& bands, int numSamples);
+
+private:
+    /**
+     * Coefficients of all filters for one configuration. The filters share these, so a set is only rewritten once no
+     * filter uses it anymore.
+     */
+    struct CoefficientSet {
+        int numCrossovers = 0;
+        array<dsp::IIR::Coefficients<float>::Ptr, MAX_NUMBER_OF_BANDS - 1> lowpasses, highpasses, allpasses;
+    };
+
+    // Calculate the coefficients for the requested frequencies at the current sample rate (not the processing thread)
+    // The replaced coefficients are moved to the release pool
+    void calculateCoefficients(CoefficientSet& set);
+    // Free the coefficients in the release pool that no filter references anymore (not the processing thread)
+    void releaseUnusedCoefficients();
+    // Point all filters to the coefficients of a set (processing thread, or while it isn't running)
+    void applyCoefficients(const CoefficientSet& set);
+
+    double sampleRate = 44100.0;
+    int maximumBlockSize = 0;
+    int numChannels = 0;
+    // Most recently requested configuration, only accessed by the thread calling setCrossoverFrequencies()
+    array<float, MAX_NUMBER_OF_BANDS - 1> crossoverFrequencies {};
+    int requestedNumCrossovers = 0;
+
+    // Triple buffer: the set being written, the set handed over and the set the filters use
+    static constexpr int NEW_SET_FLAG = 4;
+    array<CoefficientSet, 3> coefficientSets;
+    // Only accessed by the thread calling setCrossoverFrequencies()
+    int writeSet = 0;
+    // Coefficients replaced by calculateCoefficients() that a filter may still reference. The processing thread may
+    // apply a new set after its previous set was already handed back and rewritten, so dropping the old coefficients
+    // right away could leave the filters holding their last reference. Only accessed by the thread calling
+    // setCrossoverFrequencies() (and prepare()).
+    vector<dsp::IIR::Coefficients<float>::Ptr> releasePool;
+    // Index of the handed over set, NEW_SET_FLAG is added until the processing thread took it
+    atomic<int> handoverSet { 1 };
+    // Only accessed by the processing thread
+    int activeSet = 2;
+    // Number of crossovers of the active set
+    atomic<int> numCrossovers { 0 };
+    bool phaseCompensation = true;
+    // Number of crossovers used in the last call to process(), only accessed by the audio thread
+    int numProcessedCrossovers = 0;
+
+    // One SIMD register per sample, one lane per channel
+    // Band b occupies samples [b * maximumBlockSize, (b + 1) * maximumBlockSize)
+    vector<SIMDFloat> interleavedBands;
+
+    // Each LR4 filter is two cascaded Butterworth biquads, one pair per crossover
+    using Filter = dsp::IIR::Filter<SIMDFloat>;
+    array<array<Filter, 2>, MAX_NUMBER_OF_BANDS - 1> lowpasses, highpasses;
+    // Phase compensation: allpasses[k][j] is the allpass of crossover j applied to band k (only used for j > k)
+    array<array<Filter, MAX_NUMBER_OF_BANDS - 1>, MAX_NUMBER_OF_BANDS - 1> allpasses;
+
+    // Run one filter over a block of interleaved samples in place
+    static void processFilter(Filter& filter, SIMDFloat* samples, int numSamples);
+
+    static void interleave(const AudioBuffer<float>& source, SIMDFloat* dest, int numChannels, int numSamples);
+    static void deinterleave(const SIMDFloat* source, AudioBuffer<float>& dest, int destChannel, int numChannels, int numSamples);
+};
+
+
+#endif //MUSIC_VIS_BACKEND_LINKWITZRILEYCROSSOVER_H
@@ -0,0 +1,53 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "LogSpectrumReducer.h"
+
+void LogSpectrumReducer::prepare(int newNumSpectrumBins, double sampleRate, int numOutputBins, double minFrequency) {
+    jassert(newNumSpectrumBins > 1 && numOutputBins > 0 && minFrequency > 0.0);
+
+    numSpectrumBins = newNumSpectrumBins;
+    const auto nyquist = sampleRate * 0.5;
+    const auto binWidth = nyquist / (numSpectrumBins - 1);
+    const auto ratio = pow(nyquist / minFrequency, 1.0 / numOutputBins);
+
+    bins.resize(numOutputBins);
+    for (int i = 0; i < numOutputBins; i++){
+        // Edges of the output bin as fractional spectrum bin indices
+        const auto lower = minFrequency * pow(ratio, i) / binWidth;
+        const auto upper = minFrequency * pow(ratio, i + 1) / binWidth;
+        const auto start = static_cast<int>(ceil(lower));
+        const auto end = jmin(static_cast<int>(floor(upper)), numSpectrumBins - 1);
+
+        if(end >= start){
+            bins[i] = { start, end - start + 1, 0.0f };
+        } else {
+            // No spectrum bin falls into this narrow bin, interpolate at its (geometric) centre
+            const auto centre = sqrt(lower * upper);
+            const auto index = jlimit(0, numSpectrumBins - 2, static_cast<int>(centre));
+            bins[i] = { index, 0, static_cast<float>(jlimit(0.0, 1.0, centre - index)) };
+        }
+    }
+}
+
+void LogSpectrumReducer::process(const vector<Real>& spectrum, float* output) const {
+    jassert(static_cast<int>(spectrum.size()) >= numSpectrumBins);
+
+    for (size_t i = 0; i < bins.size(); i++){
+        const auto& bin = bins[i];
+        if(bin.count == 0){
+            output[i] = spectrum[bin.start] + bin.fraction * (spectrum[bin.start + 1] - spectrum[bin.start]);
+        } else {
+            float sum = 0.0f;
+            for (int k = bin.start; k < bin.start + bin.count; k++){
+                sum += spectrum[k];
+            }
+            output[i] = sum / static_cast<float>(bin.count);
+        }
+    }
+}
+
+int LogSpectrumReducer::getNumOutputBins() const {
+    return static_cast<int>(bins.size());
+}
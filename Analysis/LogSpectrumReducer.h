@@ -0,0 +1,54 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_LOGSPECTRUMREDUCER_H
+#define MUSIC_VIS_BACKEND_LOGSPECTRUMREDUCER_H
+
+#include <vector>
+#include <juce_core/juce_core.h>
+#include "../external_libraries/essentia/include/types.h"
+
+using namespace std;
+using namespace juce;
+using namespace essentia;
+
+/**
+ * Reduces a linear magnitude spectrum to logarithmically spaced bins.
+ * Output bin i covers [minFrequency * r^i, minFrequency * r^(i + 1)) with r = (nyquist / minFrequency)^(1 / numOutputBins).
+ * Bins spanning several spectrum bins hold their mean, narrower bins are interpolated at their centre frequency,
+ * so the low end keeps its resolution while the high end is compressed.
+ */
+class LogSpectrumReducer {
+public:
+    /**
+     * Precompute the bin mapping
+     * @param numSpectrumBins Number of bins of the input spectrum (frameSize / 2 + 1)
+     * @param sampleRate Sample rate of the analysed signal
+     * @param numOutputBins Number of logarithmically spaced output bins
+     * @param minFrequency Lower edge of the first output bin
+     */
+    void prepare(int numSpectrumBins, double sampleRate, int numOutputBins, double minFrequency);
+
+    /**
+     * Reduce a spectrum
+     * @param spectrum Magnitude spectrum with the number of bins passed to prepare()
+     * @param output Destination for numOutputBins values
+     */
+    void process(const vector<Real>& spectrum, float* output) const;
+
+    int getNumOutputBins() const;
+
+private:
+    struct Bin {
+        // First spectrum bin and number of spectrum bins averaged, 0 to interpolate between start and start + 1
+        int start;
+        int count;
+        float fraction;
+    };
+    vector<Bin> bins;
+    int numSpectrumBins = 0;
+};
+
+
+#endif //MUSIC_VIS_BACKEND_LOGSPECTRUMREDUCER_H
@@ -0,0 +1,88 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_SEQLOCK_H
+#define MUSIC_VIS_BACKEND_SEQLOCK_H
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+#include <juce_core/juce_core.h>
+
+using namespace std;
+using namespace juce;
+
+/**
+ * Sequence lock for a single writer and any number of readers.
+ * The writer never waits: it marks the value as being written (odd sequence number), copies it and marks it as
+ * complete again. Readers copy the value and retry if the sequence number changed in the meantime, so they always
+ * end up with a consistent copy. The value is stored in atomic words, so concurrent reads and writes are not a data race.
+ * @tparam T Trivially copyable value type
+ */
+template <typename T>
+class SeqLock {
+    static_assert(is_trivially_copyable<T>::value, "SeqLock values are copied byte-wise");
+
+public:
+    SeqLock() {
+        store(T {});
+    }
+
+    /**
+     * Publish a new value (writer thread only). Never blocks.
+     */
+    void write(const T& value) {
+        const auto sequenceNumber = sequence.load(memory_order_relaxed);
+        sequence.store(sequenceNumber + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        store(value);
+        sequence.store(sequenceNumber + 2, memory_order_release);
+    }
+
+    /**
+     * Copy the most recent complete value. Retries while a write is in progress, which only takes as long as one copy.
+     */
+    void read(T& value) const {
+        while (true){
+            const auto sequenceNumber = sequence.load(memory_order_acquire);
+            if((sequenceNumber & 1u) == 0){
+                load(value);
+                atomic_thread_fence(memory_order_acquire);
+                if(sequence.load(memory_order_relaxed) == sequenceNumber){
+                    return;
+                }
+            }
+            Thread::yield();
+        }
+    }
+
+private:
+    static constexpr size_t numWords = (sizeof(T) + sizeof(uint64) - 1) / sizeof(uint64);
+
+    void store(const T& value) {
+        const auto* bytes = reinterpret_cast<const char*>(&value);
+        for (size_t i = 0; i < numWords; i++){
+            uint64 word = 0;
+            memcpy(&word, bytes + i * sizeof(uint64), jmin(sizeof(uint64), sizeof(T) - i * sizeof(uint64)));
+            words[i].store(word, memory_order_relaxed);
+        }
+    }
+
+    void load(T& value) const {
+        auto* bytes = reinterpret_cast<char*>(&value);
+        for (size_t i = 0; i < numWords; i++){
+            const auto word = words[i].load(memory_order_relaxed);
+            memcpy(bytes + i * sizeof(uint64), &word, jmin(sizeof(uint64), sizeof(T) - i * sizeof(uint64)));
+        }
+    }
+
+    atomic<uint32> sequence { 0 };
+    array<atomic<uint64>, numWords> words {};
+
+    JUCE_DECLARE_NON_COPYABLE (SeqLock)
+};
+
+
+#endif //MUSIC_VIS_BACKEND_SEQLOCK_H
@@ -0,0 +1,110 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "YinPitchTracker.h"
+
+void YinPitchTracker::prepare(double newSampleRate, int newFrameSize) {
+    jassert(isPowerOfTwo(newFrameSize));
+    sampleRate = newSampleRate;
+    frameSize = newFrameSize;
+    windowSize = frameSize / 2;
+
+    // A lag of one sample is Nyquist, so the shortest lag searched is two samples (a pitch of half the sample rate)
+    minimumLag = 2;
+    maximumLag = jlimit(minimumLag + 1, windowSize - 1, static_cast<int>(std::ceil(sampleRate / PITCH_YIN_MIN_FREQUENCY)));
+
+    fft = make_unique<dsp::FFT>(roundToInt(std::log2(frameSize)));
+    windowSpectrum.assign(2 * frameSize, 0.0f);
+    frameSpectrum.assign(2 * frameSize, 0.0f);
+    difference.assign(windowSize, 1.0f);
+}
+
+void YinPitchTracker::process(const vector<Real>& frame, Real& pitch, Real& confidence) {
+    if(!computeDifference(frame)){
+        pitch = 0.0f;
+        confidence = 0.0f;
+        return;
+    }
+
+    // The first dip below the threshold, followed down to its local minimum
+    int tau = -1;
+    for (int lag = minimumLag; lag < maximumLag; lag++){
+        if(difference[lag] < PITCH_YIN_TOLERANCE){
+            while (lag + 1 < maximumLag && difference[lag + 1] < difference[lag]){
+                lag++;
+            }
+            tau = lag;
+            break;
+        }
+    }
+
+    // No dip below the threshold: take the global minimum, which comes with a low confidence
+    if(tau < 0){
+        tau = static_cast<int>(std::min_element(difference.begin() + minimumLag, difference.begin() + maximumLag) - difference.begin());
+    }
+
+    const auto interpolatedTau = interpolateMinimum(tau);
+    pitch = interpolatedTau > 0.0f ? static_cast<Real>(sampleRate / interpolatedTau) : 0.0f;
+    confidence = jlimit(0.0f, 1.0f, 1.0f - difference[tau]);
+}
+
+bool YinPitchTracker::computeDifference(const vector<Real>& frame) {
+    jassert(static_cast<int>(frame.size()) >= frameSize);
+
+    // r(tau) = sum_j x_j * x_{j+tau} for j < windowSize, as the inverse FFT of conj(X_window) * X_frame
+    // Zero-padding the window to frameSize avoids any circular wrap-around for tau < windowSize
+    std::copy_n(frame.begin(), windowSize, windowSpectrum.begin());
+    std::fill(windowSpectrum.begin() + windowSize, windowSpectrum.end(), 0.0f);
+    std::copy_n(frame.begin(), frameSize, frameSpectrum.begin());
+    std::fill(frameSpectrum.begin() + frameSize, frameSpectrum.end(), 0.0f);
+    fft->performRealOnlyForwardTransform(windowSpectrum.data());
+    fft->performRealOnlyForwardTransform(frameSpectrum.data());
+
+    for (int bin = 0; bin < frameSize; bin++){
+        const auto re = 2 * bin;
+        const auto im = re + 1;
+        const auto real = windowSpectrum[re] * frameSpectrum[re] + windowSpectrum[im] * frameSpectrum[im];
+        const auto imaginary = windowSpectrum[re] * frameSpectrum[im] - windowSpectrum[im] * frameSpectrum[re];
+        frameSpectrum[re] = real;
+        frameSpectrum[im] = imaginary;
+    }
+    // Normalised by JUCE, the correlation is in the first frameSize values
+    fft->performRealOnlyInverseTransform(frameSpectrum.data());
+    const auto* correlation = frameSpectrum.data();
+
+    // Energies of the first window and of the window at tau, as a sliding sum
+    double firstEnergy = 0.0;
+    for (int j = 0; j < windowSize; j++){
+        firstEnergy += frame[j] * frame[j];
+    }
+    double shiftedEnergy = firstEnergy;
+
+    // Cumulative mean normalised difference, d'(0) = 1
+    difference[0] = 1.0f;
+    double runningSum = 0.0;
+    for (int tau = 1; tau < windowSize; tau++){
+        shiftedEnergy += static_cast<double>(frame[tau + windowSize - 1]) * frame[tau + windowSize - 1]
+                         - static_cast<double>(frame[tau - 1]) * frame[tau - 1];
+        // Rounding can make tiny differences negative
+        const auto value = jmax(0.0, firstEnergy + shiftedEnergy - 2.0 * correlation[tau]);
+        runningSum += value;
+        difference[tau] = runningSum > 0.0 ? static_cast<float>(value * tau / runningSum) : 1.0f;
+    }
+    return runningSum > 0.0;
+}
+
+float YinPitchTracker::interpolateMinimum(int tau) const {
+    if(tau <= 0 || tau >= windowSize - 1){
+        return static_cast<float>(tau);
+    }
+
+    const auto previous = difference[tau - 1];
+    const auto current = difference[tau];
+    const auto next = difference[tau + 1];
+    const auto denominator = previous - 2.0f * current + next;
+    if(std::abs(denominator) < 1.0e-9f){
+        return static_cast<float>(tau);
+    }
+    return static_cast<float>(tau) + 0.5f * (previous - next) / denominator;
+}
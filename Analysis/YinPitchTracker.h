@@ -0,0 +1,66 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_YINPITCHTRACKER_H
+#define MUSIC_VIS_BACKEND_YINPITCHTRACKER_H
+
+#include <vector>
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../external_libraries/essentia/include/types.h"
+#include "../Constants.h"
+
+using namespace std;
+using namespace juce;
+using namespace essentia;
+
+/**
+ * YIN pitch estimation with an FFT-based difference function, a drop-in replacement for Essentia's PitchYin with the
+ * same outputs (pitch in Hz and confidence = 1 - the minimum of the normalised difference).
+ * The difference function over a window of W = frameSize / 2 samples is
+ *     d(tau) = sum_j (x_j - x_{j+tau})^2 = e(0) + e(tau) - 2 r(tau)
+ * where e(tau) is the energy of the window starting at tau (a sliding sum) and r(tau) the cross-correlation of the
+ * first window with the frame, computed with two forward and one inverse FFT of frameSize. The cost per frame is
+ * O(N log N) instead of O(N^2) and doesn't depend on the signal, so the analysis time stays constant.
+ * All buffers are allocated in prepare().
+ */
+class YinPitchTracker {
+public:
+    /**
+     * @param sampleRate Sample rate of the frames
+     * @param frameSize Number of samples per frame, a power of two
+     */
+    void prepare(double sampleRate, int frameSize);
+
+    /**
+     * Estimate the pitch of a frame
+     * @param frame frameSize samples (not windowed)
+     * @param pitch Set to the estimated fundamental frequency in Hz, 0 if the frame is silent
+     * @param confidence Set to the confidence of the estimate in [0, 1]
+     */
+    void process(const vector<Real>& frame, Real& pitch, Real& confidence);
+
+private:
+    // Compute the cumulative mean normalised difference function of the frame, returns false if the frame is silent
+    bool computeDifference(const vector<Real>& frame);
+    // Parabolic interpolation of the minimum around tau
+    float interpolateMinimum(int tau) const;
+
+    double sampleRate = 0.0;
+    int frameSize = 0;
+    int windowSize = 0;
+    // Range of lags searched, from two samples up to the period of PITCH_YIN_MIN_FREQUENCY
+    int minimumLag = 2;
+    int maximumLag = 1;
+
+    unique_ptr<dsp::FFT> fft;
+    // Interleaved spectra of the zero-padded first window and of the whole frame, twice frameSize as JUCE requires
+    vector<float> windowSpectrum;
+    vector<float> frameSpectrum;
+    // Normalised difference function, windowSize values
+    vector<float> difference;
+};
+
+
+#endif //MUSIC_VIS_BACKEND_YINPITCHTRACKER_H
@@ -0,0 +1,302 @@
+//
+// Created by Max on 17/10/2026.
+// CPU and realtime-safety benchmark of the processor
+//
+
+#include <iostream>
+#include "../PluginProcessor.h"
+
+using namespace std;
+using namespace juce;
+
+/**
+ * FeatureSlot algorithms selected in every band of a benchmark case
+ */
+struct SlotConfiguration {
+    String name;
+    array<String, NUMBER_OF_SLOTS> algorithms;
+};
+
+/**
+ * Timings of a number of blocks
+ */
+struct BlockStatistics {
+    int64 numSamples = 0;
+    int64 numBlocks = 0;
+    double totalSeconds = 0.0;
+    double worstBlockSeconds = 0.0;
+    int64 numAllocations = 0;
+
+    void add(int blockSize, double seconds) {
+        numSamples += blockSize;
+        numBlocks++;
+        totalSeconds += seconds;
+        worstBlockSeconds = jmax(worstBlockSeconds, seconds);
+    }
+
+    double getNanosecondsPerSample() const {
+        return numSamples > 0 ? 1.0e9 * totalSeconds / static_cast<double>(numSamples) : 0.0;
+    }
+};
+
+/**
+ * Command line settings of the benchmark
+ */
+struct BenchmarkSettings {
+    Array<double> sampleRates { 44100.0, 48000.0, 96000.0 };
+    Array<int> blockSizes { 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+    Array<int> bandCounts { 1, 4, MAX_NUMBER_OF_BANDS };
+    Array<SlotConfiguration> slotConfigurations {
+            { "none", { "-", "-" } },
+            { "time", { "Loudness", "RMS" } },
+            { "spectrum", { "Spectral Flux", "Spectral Rolloff" } },
+            { "pitch", { "Pitch (YIN)", "MFCC Energy" } }
+    };
+    // Length of the synthetic signal analysed per case
+    double seconds = 2.0;
+    // Only cases whose name contains this are run
+    String filter;
+    File csvFile;
+
+    bool shouldRun(const String& caseName) const {
+        return filter.isEmpty() || caseName.contains(filter);
+    }
+};
+
+static double ticksToSeconds(int64 ticks) {
+    return Time::highResolutionTicksToSeconds(ticks);
+}
+
+/**
+ * Synthetic test signal: an exponential sine sweep in the left and a decaying pulse train over noise in the right
+ * channel, so the pitch, onset and spectral algorithms all have something to track
+ */
+static AudioBuffer<float> createTestSignal(double sampleRate, double seconds) {
+    const auto numSamples = roundToInt(sampleRate * seconds);
+    AudioBuffer<float> signal(2, numSamples);
+    Random random(42);
+
+    const auto startFrequency = 40.0;
+    const auto endFrequency = jmin(16000.0, 0.45 * sampleRate);
+    const auto sweepRate = log(endFrequency / startFrequency) / seconds;
+    const auto pulseInterval = roundToInt(sampleRate * 0.25);
+
+    auto* left = signal.getWritePointer(0);
+    auto* right = signal.getWritePointer(1);
+    for (int i = 0; i < numSamples; i++){
+        const auto time = i / sampleRate;
+        const auto phase = MathConstants<double>::twoPi * startFrequency * (exp(sweepRate * time) - 1.0) / sweepRate;
+        left[i] = 0.5f * static_cast<float>(sin(phase));
+
+        const auto pulse = static_cast<float>(exp(-static_cast<double>(i % pulseInterval) / (0.01 * sampleRate)));
+        right[i] = 0.8f * pulse * (random.nextFloat() * 2.0f - 1.0f) + 0.05f * (random.nextFloat() * 2.0f - 1.0f);
+    }
+    return signal;
+}
+
+static void setParameter(AudioPluginAudioProcessor& processor, const String& parameterID, float value) {
+    auto* parameter = processor.getMagicState().getValueTreeState().getParameter(parameterID);
+    jassert(parameter != nullptr);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+static void configure(AudioPluginAudioProcessor& processor, int numBands, const SlotConfiguration& slots) {
+    // The cutoffs are set before the band count, in 2-band mode the highpass cutoff would overwrite the lowpass one
+    setParameter(processor, "lowpassCutoff", 200.0f);
+    if(numBands != 2){
+        setParameter(processor, "highpassCutoff", 6000.0f);
+    }
+    setParameter(processor, "numberOfBands", static_cast<float>(numBands - 1));
+    for (int band = 0; band < MAX_NUMBER_OF_BANDS; band++){
+        for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++){
+            const auto& algorithm = band < numBands ? slots.algorithms[slot] : featureSlotAlgorithmOptions[0];
+            setParameter(processor, getBandSlotID(band, slot + 1), static_cast<float>(featureSlotAlgorithmOptions.indexOf(algorithm)));
+        }
+    }
+}
+
+// Rebuild the FeatureSlots right away instead of waiting for the message loop
+static void applySlotChanges(AudioPluginAudioProcessor& processor) {
+    for (auto& slots : processor.getBandSlots()){
+        for (auto& featureSlot : slots){
+            featureSlot->applyPendingChanges();
+        }
+    }
+}
+
+/**
+ * Feed the whole signal through processBlock in blocks of blockSize, while the analysis thread runs as in a host
+ */
+static BlockStatistics runProcessBlock(AudioPluginAudioProcessor& processor, const AudioBuffer<float>& signal,
+                                       double sampleRate, int blockSize) {
+    processor.prepareToPlay(sampleRate, blockSize);
+    applySlotChanges(processor);
+
+    AudioBuffer<float> block(2, blockSize);
+    MidiBuffer midi;
+    BlockStatistics statistics;
+
+    // The first pass warms up caches and the analysis thread and isn't measured
+    for (int pass = 0; pass < 2; pass++){
+        for (int startSample = 0; startSample + blockSize <= signal.getNumSamples(); startSample += blockSize){
+            for (int channel = 0; channel < 2; channel++){
+                block.copyFrom(channel, 0, signal, channel, startSample, blockSize);
+            }
+
+            const auto allocationsBefore = ScopedRealtimeAllocationCheck::getNumRealtimeAllocations();
+            const auto start = Time::getHighResolutionTicks();
+            processor.processBlock(block, midi);
+            const auto seconds = ticksToSeconds(Time::getHighResolutionTicks() - start);
+
+            if(pass == 1){
+                statistics.add(blockSize, seconds);
+                statistics.numAllocations += ScopedRealtimeAllocationCheck::getNumRealtimeAllocations() - allocationsBefore;
+            }
+        }
+    }
+    return statistics;
+}
+
+/**
+ * Analyse the whole signal synchronously, i.e. the cost of the analysis thread per input sample
+ */
+static BlockStatistics runAnalysis(AudioPluginAudioProcessor& processor, const AudioBuffer<float>& signal,
+                                   double sampleRate) {
+    const auto blockSize = 512;
+    auto& worker = processor.prepareForOfflineAnalysis(sampleRate, blockSize);
+    const auto source = AnalysisWorker::MONO;
+    BlockStatistics statistics;
+
+    for (int pass = 0; pass < 2; pass++){
+        for (int startSample = 0; startSample + blockSize <= signal.getNumSamples(); startSample += blockSize){
+            const auto start = Time::getHighResolutionTicks();
+            worker.analyse(signal.getReadPointer(0, startSample), signal.getReadPointer(1, startSample), blockSize, source);
+            if(pass == 1){
+                statistics.add(blockSize, ticksToSeconds(Time::getHighResolutionTicks() - start));
+            }
+        }
+    }
+    return statistics;
+}
+
+static void printUsage() {
+    cout << "Usage: music-vis-backend-benchmark [options]\n"
+            "Runs processBlock and the analysis over all combinations of sample rate, block size, band count and\n"
+            "FeatureSlot configuration and reports the time per sample, the worst block and the allocations.\n\n"
+            "Options:\n"
+            "  --quick            Only a few block sizes, 48 kHz and the smallest and largest band count\n"
+            "  --seconds=<n>      Length of the test signal per case (default 2)\n"
+            "  --filter=<text>    Only run cases whose name contains the text\n"
+            "  --csv=<file>       Also write the results to a CSV file\n"
+            "  --help             Show this message\n\n"
+            "Exits with 1 if processBlock allocated memory." << endl;
+}
+
+int main(int argc, char* argv[]) {
+    ArgumentList arguments(argc, argv);
+    BenchmarkSettings settings;
+
+    for (const auto& argument : arguments.arguments){
+        const auto text = argument.text;
+        const auto value = text.fromFirstOccurrenceOf("=", false, false);
+
+        if(text == "--help" || text == "-h"){
+            printUsage();
+            return 0;
+        } else if(text == "--quick"){
+            settings.sampleRates = { 48000.0 };
+            settings.blockSizes = { 64, 512, 4096 };
+            settings.bandCounts = { 1, MAX_NUMBER_OF_BANDS };
+        } else if(text.startsWith("--seconds=")){
+            settings.seconds = jmax(0.1, value.getDoubleValue());
+        } else if(text.startsWith("--filter=")){
+            settings.filter = value;
+        } else if(text.startsWith("--csv=")){
+            settings.csvFile = File::getCurrentWorkingDirectory().getChildFile(value);
+        } else {
+            cerr << "Unknown option: " << text << endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+   #if ! MUSIC_VIS_BACKEND_TRACK_ALLOCATIONS
+    cerr << "Warning: allocation tracking is disabled, allocations are not counted" << endl;
+   #endif
+
+    // The processor and its parameters need the message manager
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    StringArray csvLines { "case,nsPerSample,worstBlockUs,worstBlockPercentOfBudget,allocations" };
+    int64 totalAllocations = 0;
+
+    cout << String("Case").paddedRight(' ', 64) << String("ns/sample").paddedLeft(' ', 12)
+         << String("worst us").paddedLeft(' ', 12) << String("% budget").paddedLeft(' ', 10)
+         << String("allocs").paddedLeft(' ', 8) << endl;
+
+    auto report = [&](const String& name, const BlockStatistics& statistics, double blockSeconds){
+        const auto budgetPercent = 100.0 * statistics.worstBlockSeconds / blockSeconds;
+        cout << name.paddedRight(' ', 64)
+             << String(statistics.getNanosecondsPerSample(), 2).paddedLeft(' ', 12)
+             << String(1.0e6 * statistics.worstBlockSeconds, 1).paddedLeft(' ', 12)
+             << String(budgetPercent, 2).paddedLeft(' ', 10)
+             << String(statistics.numAllocations).paddedLeft(' ', 8) << endl;
+        csvLines.add(name + "," + String(statistics.getNanosecondsPerSample(), 3) + ","
+                     + String(1.0e6 * statistics.worstBlockSeconds, 3) + "," + String(budgetPercent, 3) + ","
+                     + String(statistics.numAllocations));
+    };
+
+    for (auto sampleRate : settings.sampleRates){
+        const auto signal = createTestSignal(sampleRate, settings.seconds);
+
+        for (auto numBands : settings.bandCounts){
+            for (const auto& slots : settings.slotConfigurations){
+                const auto configuration = "sr:" + String(roundToInt(sampleRate)) + "/bands:" + String(numBands)
+                                           + "/slots:" + slots.name;
+                // One processor per configuration, the block sizes only need a new prepareToPlay
+                auto processor = make_unique<AudioPluginAudioProcessor>();
+                configure(*processor, numBands, slots);
+
+                // Monitoring a soloed band is the only case that splits the bands on the audio thread
+                for (auto monitoring : { false, true }){
+                    if(monitoring && numBands == 1){
+                        continue;
+                    }
+                    setParameter(*processor, "bandMonitoring", monitoring ? 1.0f : 0.0f);
+                    setParameter(*processor, getBandSoloID(0), monitoring ? 1.0f : 0.0f);
+
+                    for (auto blockSize : settings.blockSizes){
+                        const auto name = "processBlock/" + configuration + "/block:" + String(blockSize)
+                                          + "/monitoring:" + (monitoring ? "on" : "off");
+                        if(!settings.shouldRun(name)){
+                            continue;
+                        }
+
+                        const auto statistics = runProcessBlock(*processor, signal, sampleRate, blockSize);
+                        totalAllocations += statistics.numAllocations;
+                        report(name, statistics, blockSize / sampleRate);
+                    }
+                }
+
+                // The analysis thread's cost doesn't depend on the host block size
+                const auto name = "analysis/" + configuration;
+                if(settings.shouldRun(name)){
+                    report(name, runAnalysis(*processor, signal, sampleRate), 512 / sampleRate);
+                }
+            }
+        }
+    }
+
+    if(settings.csvFile != File()){
+        if(!settings.csvFile.replaceWithText(csvLines.joinIntoString("\n") + "\n")){
+            cerr << "Could not write " << settings.csvFile.getFullPathName() << endl;
+            return 1;
+        }
+    }
+
+    if(totalAllocations > 0){
+        cerr << "processBlock allocated " << totalAllocations << " times" << endl;
+        return 1;
+    }
+    return 0;
+}
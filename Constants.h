@@ -11,13 +11,113 @@
 // sqrt(2)/2 for standard filter quality value
 const double SQRT_2_OVER_2 = sqrt(2.0) / 2.0;
 
-// Algorithms supported by feature slots
-static juce::StringArray featureSlotAlgorithmOptions = { "-", "Loudness", "Spectral Centroid" };
-
 // Number of feature slots per band
 const int NUMBER_OF_SLOTS = 2;
 
+// Maximum number of sub-bands the signal can be split into
+const int MAX_NUMBER_OF_BANDS = 8;
+
 // Number of automatables
 const int NUMBER_OF_AUTOMATABLES = 5;
 
+// Sample rate the analysis input is decimated to (approximately, the decimation factor is an integer)
+const double ANALYSIS_TARGET_SAMPLE_RATE = 48000.0;
+
+// Length of each polyphase branch of the decimation filter
+const int DECIMATOR_TAPS_PER_PHASE = 16;
+
+// Cutoff of the decimation filter relative to the Nyquist frequency of the analysis sample rate
+const double DECIMATOR_CUTOFF_RATIO = 0.9;
+
+// Number of samples per analysis frame, independent of the host's block size
+// Must be a power of two as every frame is passed to the FFT
+const int ANALYSIS_FRAME_SIZE = 2048;
+static_assert((ANALYSIS_FRAME_SIZE & (ANALYSIS_FRAME_SIZE - 1)) == 0, "Analysis frame size must be a power of two");
+
+// Number of samples between the starts of two consecutive analysis frames
+const int ANALYSIS_HOP_SIZE = 512;
+
+// Capacity of the analysis FIFO in host blocks (or frames, whichever is larger) before samples are dropped
+const int ANALYSIS_FIFO_BLOCKS = 8;
+
+// Capacity of the queue of host timeline anchors (one per block) before anchors are dropped
+const int ANALYSIS_TIMELINE_ANCHORS = 256;
+
+// Maximum time the analysis thread sleeps if it is not woken up by the audio thread
+const int ANALYSIS_THREAD_WAIT_TIMEOUT_MS = 50;
+
+// Time to wait for the analysis thread to finish its current block when stopping it
+const int ANALYSIS_THREAD_STOP_TIMEOUT_MS = 1000;
+
+// Delay before a FeatureSlot tries again to delete an algorithm the analysis thread may still be computing
+const int FEATURE_SLOT_RETIRE_RETRY_MS = 20;
+
+// Maximum number of consumers that are notified when an analysis frame is ready
+const int ANALYSIS_MAX_FRAME_LISTENERS = 4;
+
+// Default maximum rate at which libmapper signals are updated, frames that arrive faster are coalesced
+const double LIBMAPPER_MAX_PUBLISH_RATE_HZ = 100.0;
+
+// Interval at which the libmapper device is polled for incoming messages while no frames arrive
+const int LIBMAPPER_IDLE_POLL_INTERVAL_MS = 100;
+
+// Maximum rate at which the feature values displayed in the GUI are updated
+const double GUI_MAX_UPDATE_RATE_HZ = 30.0;
+
+// Time to wait for the libmapper thread to finish its current tick when stopping it
+const int LIBMAPPER_THREAD_STOP_TIMEOUT_MS = 1000;
+
+// Maximum length of a libmapper vector signal, longer vectors are split into several signals
+const int LIBMAPPER_MAX_VECTOR_LENGTH = 128;
+
+// Number of logarithmically spaced spectrum bins published over libmapper, sent in chunks of LIBMAPPER_MAX_VECTOR_LENGTH
+const int SPECTRUM_PUBLISH_BINS = 512;
+static_assert(SPECTRUM_PUBLISH_BINS % LIBMAPPER_MAX_VECTOR_LENGTH == 0, "Published spectrum must consist of whole chunks");
+
+// Lower edge of the first published spectrum bin in Hz, the last one ends at the Nyquist frequency
+const double SPECTRUM_PUBLISH_MIN_FREQUENCY = 20.0;
+
+// Number of mel bands computed and published over libmapper
+const int NUMBER_OF_MEL_BANDS = 128;
+
+// Maximum rate at which the spectrum and mel bands are published over libmapper
+const int SPECTRUM_PUBLISH_RATE_HZ = 60;
+
+// Number of samples read from a file and analysed at once by the offline analysis
+const int OFFLINE_BLOCK_SIZE = 65536;
+
+// Resolution and range of the analysis timing histograms: 20 octaves from 0.25 µs to about 260 ms
+const int TIMING_HISTOGRAM_BUCKETS_PER_OCTAVE = 4;
+const int TIMING_HISTOGRAM_BUCKETS = 20 * TIMING_HISTOGRAM_BUCKETS_PER_OCTAVE;
+const double TIMING_HISTOGRAM_MIN_MICROSECONDS = 0.25;
+
+// Number of recordings after which the counts of a timing histogram are halved, so old measurements fade out
+const int TIMING_HISTOGRAM_WINDOW = 512;
+
+// Rate at which the analysis timings are updated in the diagnostics panel and published over libmapper
+const int DIAGNOSTICS_UPDATE_RATE_HZ = 4;
+
+// Share of the hop duration the analysis may spend per frame before expensive features are computed less often
+const double ANALYSIS_LOAD_BUDGET = 0.6;
+
+// The rate of expensive features is raised again once the load drops below this share of the budget
+const double ANALYSIS_LOAD_RECOVERY_RATIO = 0.4;
+
+// Weight of the newest frame in the smoothed analysis load
+const double ANALYSIS_LOAD_SMOOTHING = 0.05;
+
+// Minimum number of frames between two changes of the load shedding level
+const int ANALYSIS_GOVERNOR_HOLD_FRAMES = 50;
+
+// Highest load shedding level, at which expensive features are computed 2^level times less often than scheduled
+const int ANALYSIS_MAX_SHEDDING_LEVEL = 3;
+
+// Longest interval in frames between two computations of a feature before load shedding (a power of two)
+const int ANALYSIS_MAX_SCHEDULE_INTERVAL = 16;
+
+// Parameters of the global YIN pitch tracker, as the defaults of Essentia's PitchYin
+// The highest pitch is only limited by the shortest lag, see YinPitchTracker
+const double PITCH_YIN_MIN_FREQUENCY = 20.0;
+const float PITCH_YIN_TOLERANCE = 0.15f;
+
 #endif //MUSIC_VIS_BACKEND_CONSTANTS_H
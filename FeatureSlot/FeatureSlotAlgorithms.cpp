@@ -0,0 +1,139 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "FeatureSlotAlgorithms.h"
+
+namespace {
+    // Most algorithms have a single scalar output
+    Real scalarValue(const FeatureSlotOutput& output) {
+        return output.scalar;
+    }
+
+    // The factory is only looked up when an algorithm is created, as the registry may be built before essentia::init()
+    standard::AlgorithmFactory& getFactory() {
+        return standard::AlgorithmFactory::instance();
+    }
+
+    vector<FeatureSlotAlgorithm> createRegistry() {
+        return {
+            // No algorithm selected
+            { "-", FeatureSlotAlgorithm::TIME, nullptr, scalarValue },
+
+            { "Loudness", FeatureSlotAlgorithm::TIME,
+              [](const vector<Real>& input, FeatureSlotOutput& output, double, int){
+                  auto* algorithm = getFactory().create("Loudness");
+                  algorithm->input("signal").set(input);
+                  algorithm->output("loudness").set(output.scalar);
+                  return algorithm;
+              }, scalarValue },
+
+            { "Spectral Centroid", FeatureSlotAlgorithm::TIME,
+              [](const vector<Real>& input, FeatureSlotOutput& output, double sampleRate, int){
+                  auto* algorithm = getFactory().create("SpectralCentroidTime", "sampleRate", sampleRate);
+                  algorithm->input("array").set(input);
+                  algorithm->output("centroid").set(output.scalar);
+                  return algorithm;
+              }, scalarValue },
+
+            { "Spectral Flux", FeatureSlotAlgorithm::SPECTRUM,
+              [](const vector<Real>& input, FeatureSlotOutput& output, double, int){
+                  auto* algorithm = getFactory().create("Flux");
+                  algorithm->input("spectrum").set(input);
+                  algorithm->output("flux").set(output.scalar);
+                  return algorithm;
+              }, scalarValue },
+
+            { "Spectral Rolloff", FeatureSlotAlgorithm::SPECTRUM,
+              [](const vector<Real>& input, FeatureSlotOutput& output, double sampleRate, int){
+                  auto* algorithm = getFactory().create("RollOff", "sampleRate", sampleRate);
+                  algorithm->input("spectrum").set(input);
+                  algorithm->output("rollOff").set(output.scalar);
+                  return algorithm;
+              }, scalarValue },
+
+            { "Spectral Flatness", FeatureSlotAlgorithm::SPECTRUM,
+              [](const vector<Real>& input, FeatureSlotOutput& output, double, int){
+                  auto* algorithm = getFactory().create("Flatness");
+                  algorithm->input("array").set(input);
+                  algorithm->output("flatness").set(output.scalar);
+                  return algorithm;
+              }, scalarValue },
+
+            { "HFC Onset", FeatureSlotAlgorithm::SPECTRUM,
+              [](const vector<Real>& input, FeatureSlotOutput& output, double sampleRate, int){
+                  auto* algorithm = getFactory().create("OnsetDetection", "method", "hfc", "sampleRate", sampleRate);
+                  algorithm->input("spectrum").set(input);
+                  // Phase is only used by the complex ODF, an empty vector is sufficient for HFC
+                  algorithm->input("phase").set(output.auxiliaryValues);
+                  algorithm->output("onsetDetection").set(output.scalar);
+                  return algorithm;
+              }, scalarValue },
+
+            { "RMS", FeatureSlotAlgorithm::TIME,
+              [](const vector<Real>& input, FeatureSlotOutput& output, double, int){
+                  auto* algorithm = getFactory().create("RMS");
+                  algorithm->input("array").set(input);
+                  algorithm->output("rms").set(output.scalar);
+                  return algorithm;
+              }, scalarValue },
+
+            { "Zero Crossing Rate", FeatureSlotAlgorithm::TIME,
+              [](const vector<Real>& input, FeatureSlotOutput& output, double, int){
+                  auto* algorithm = getFactory().create("ZeroCrossingRate");
+                  algorithm->input("signal").set(input);
+                  algorithm->output("zeroCrossingRate").set(output.scalar);
+                  return algorithm;
+              }, scalarValue },
+
+            { "Pitch (YIN)", FeatureSlotAlgorithm::TIME,
+              [](const vector<Real>& input, FeatureSlotOutput& output, double sampleRate, int frameSize){
+                  auto* algorithm = getFactory().create("PitchYin", "sampleRate", sampleRate, "frameSize", frameSize);
+                  algorithm->input("signal").set(input);
+                  algorithm->output("pitch").set(output.scalar);
+                  algorithm->output("pitchConfidence").set(output.auxiliaryScalar);
+                  return algorithm;
+              },
+              // Only report a pitch if confidence is greater than chance (same gating as the global pitch)
+              [](const FeatureSlotOutput& output){
+                  return output.auxiliaryScalar > 0.5f ? output.scalar : -1.0f;
+              } },
+
+            { "MFCC Energy", FeatureSlotAlgorithm::SPECTRUM,
+              [](const vector<Real>& input, FeatureSlotOutput& output, double sampleRate, int frameSize){
+                  auto* algorithm = getFactory().create("MFCC", "sampleRate", sampleRate, "inputSize", frameSize / 2 + 1,
+                                                   "highFrequencyBound", jmin(11000.0, sampleRate / 2.0));
+                  algorithm->input("spectrum").set(input);
+                  algorithm->output("bands").set(output.auxiliaryValues);
+                  algorithm->output("mfcc").set(output.values);
+                  return algorithm;
+              },
+              // The 0th cepstral coefficient is the log energy of the band
+              [](const FeatureSlotOutput& output){
+                  return output.values.empty() ? 0.0f : output.values[0];
+              } },
+        };
+    }
+}
+
+const vector<FeatureSlotAlgorithm> &FeatureSlotAlgorithms::getAll() {
+    static const vector<FeatureSlotAlgorithm> registry = createRegistry();
+    return registry;
+}
+
+const FeatureSlotAlgorithm *FeatureSlotAlgorithms::find(const String &name) {
+    for (auto& entry : getAll()){
+        if(entry.name == name){
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+StringArray FeatureSlotAlgorithms::getNames() {
+    StringArray names;
+    for (auto& entry : getAll()){
+        names.add(entry.name);
+    }
+    return names;
+}
@@ -0,0 +1,75 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_FEATURESLOTALGORITHMS_H
+#define MUSIC_VIS_BACKEND_FEATURESLOTALGORITHMS_H
+
+#include <functional>
+#include <juce_core/juce_core.h>
+#include "../external_libraries/essentia/include/algorithmfactory.h"
+
+using namespace std;
+using namespace juce;
+using namespace essentia;
+using namespace essentia::standard;
+
+/**
+ * Storage for the outputs of a FeatureSlot's Essentia algorithm
+ */
+struct FeatureSlotOutput {
+    // Scalar output (or a secondary scalar, e.g. the pitch confidence)
+    Real scalar = 0.0f;
+    Real auxiliaryScalar = 0.0f;
+    // Vector outputs
+    vector<Real> values;
+    vector<Real> auxiliaryValues;
+};
+
+/**
+ * Entry of the FeatureSlot algorithm registry
+ */
+struct FeatureSlotAlgorithm {
+    /**
+     * Enum for the input an algorithm consumes: the band's time-domain frame or its shared spectrum
+     */
+    enum InputType {
+        TIME,
+        SPECTRUM
+    };
+
+    // Name displayed in the FeatureSlot's combo box
+    String name;
+    InputType inputType;
+    /**
+     * Creates the configured Essentia algorithm and connects it to its input and output
+     * Arguments: input buffer, output storage, sample rate, frame size
+     */
+    function<Algorithm*(const vector<Real>&, FeatureSlotOutput&, double, int)> create;
+    // Extracts the slot's value from the output storage after compute()
+    function<Real(const FeatureSlotOutput&)> getValue;
+};
+
+/**
+ * Registry of all algorithms available in the FeatureSlots.
+ * The order of the entries is the order of the parameter choices, so new entries must only be appended.
+ */
+class FeatureSlotAlgorithms {
+public:
+    static const vector<FeatureSlotAlgorithm>& getAll();
+
+    /**
+     * Look up an algorithm by its display name
+     * @param name The name shown in the combo box
+     * @return The entry, or nullptr if there is none with this name
+     */
+    static const FeatureSlotAlgorithm* find(const String& name);
+
+    // Display names of all entries, in registry order
+    static StringArray getNames();
+};
+
+// Algorithms supported by feature slots
+static juce::StringArray featureSlotAlgorithmOptions = FeatureSlotAlgorithms::getNames();
+
+#endif //MUSIC_VIS_BACKEND_FEATURESLOTALGORITHMS_H
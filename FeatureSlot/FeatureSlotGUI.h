@@ -7,6 +7,7 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "../foleys_gui_magic/foleys_gui_magic.h"
 #include "../Constants.h"
+#include "FeatureSlotAlgorithms.h"
 
 using namespace std;
 using namespace juce;
@@ -4,11 +4,11 @@
 
 #include "FeatureSlotProcessor.h"
 
-FeatureSlotProcessor::FeatureSlotProcessor(mapper::Device& libmapperDev, foleys::MagicProcessorState& ms, Band b, vector<Real>& inputBuffer, int slotNo):
-        libmapperDevice(libmapperDev), magicState(ms), band(b), inputAudioBuffer(inputBuffer), slotNumber(slotNo) {
+FeatureSlotProcessor::FeatureSlotProcessor(mapper::Device* libmapperDevice, foleys::MagicProcessorState& ms, int b, BandAnalysisGraph& bandGraph, int slotNo):
+        magicState(ms), band(b), bandGraph(bandGraph), inputAudioBuffer(bandGraph.getAudioBuffer()),
+        inputSpectrum(bandGraph.getSpectrum()), slotNumber(slotNo) {
     // Get connected property from state management
-    std::string algoProp = band == LOW ? "low" : band == MID ? "mid" : "high";
-    algoProp.append("Slot").append(to_string(slotNo));
+    std::string algoProp = getBandSlotID(band, slotNo).toStdString();
 
     // Connect parameter listener with state management
     paramID = algoProp;
@@ -24,47 +24,95 @@ FeatureSlotProcessor::FeatureSlotProcessor(mapper::Device& libmapperDev, foleys:
     outputValue.referTo(magicState.getPropertyAsValue(val));
 
     // Create libmapper signal for this FeatureSlot
-    sensor = make_unique<mapper::Signal>(libmapperDevice.add_output_signal(algoProp.insert(0, "sub_"), 1, 'f', 0, 0, 0));
-    // Limit transmission rate to 30 times per second
-    // Note: This has no impact on the frame rate in the frontend
-    sensor->set_rate(30);
-
-    // Start timer for GUI updates
-    stopTimer();
-    startTimer(30);
+    if(libmapperDevice != nullptr){
+        sensor = make_unique<mapper::Signal>(libmapperDevice->add_output_signal(algoProp.insert(0, "sub_"), 1, 'f', 0, 0, 0));
+        // Limit transmission rate to 30 times per second
+        // Note: This has no impact on the frame rate in the frontend
+        // The signal is updated by the processor's LibmapperPublisher
+        sensor->set_rate(30);
+    }
 }
 
 FeatureSlotProcessor::~FeatureSlotProcessor() {
     magicState.getValueTreeState().removeParameterListener(paramID, this);
+    cancelPendingUpdate();
+    stopTimer();
+
+    // The processor stops the analysis thread before the slots are destroyed, so everything can be deleted here
+    delete activeInstance.exchange(nullptr);
+    retiredInstances.clear();
 }
 
 void FeatureSlotProcessor::compute() {
-    // Only compute if there is an algorithm selected and the algorithm is not currently changing.
-    if(algorithm != nullptr && !isAlgorithmChanging.load()){
+    // Announce the computation before the instance is loaded, so the message thread won't delete it while in use
+    computeStarted.fetch_add(1);
+
+    // Only compute if there is an algorithm selected
+    // The instance is loaded once, so the input that is prepared always matches the algorithm that reads it
+    if(auto* instance = activeInstance.load()){
+        if(instance->entry->inputType == FeatureSlotAlgorithm::SPECTRUM){
+            bandGraph.ensureSpectrum();
+        }
+
         // Compute output value
-        algorithm->compute();
+        instance->algorithm->compute();
 
         // Update output value for label
-        currentValue = outputScalar;
+        currentValue.store(instance->entry->getValue(instance->output));
     }
+
+    computeFinished.fetch_add(1);
 }
 
 void FeatureSlotProcessor::initialiseAlgorithm(String algoStr) {
-    // Algorithm initialisation
-    // If there is no algorithm selected, reset the algorithm field to nullptr
-    if(algoStr == "-"){
-        algorithm.reset(nullptr);
+    currentAlgoString = algoStr;
+
+    // Algorithm initialisation, done off the analysis thread
+    // If there is no algorithm selected, the new instance stays nullptr
+    unique_ptr<AlgorithmInstance> newInstance;
+    const auto* entry = FeatureSlotAlgorithms::find(algoStr);
+
+    if(entry != nullptr && entry->create != nullptr){
+        // Otherwise initialise with respective algorithm
+        // Fall back to the target rate if the processor hasn't been prepared yet
+        auto sampleRateValue = magicState.getPropertyAsValue("analysisSampleRate").getValue();
+        double sampleRate = sampleRateValue.isVoid() ? ANALYSIS_TARGET_SAMPLE_RATE : static_cast<double>(sampleRateValue);
+
+        // Connect to the band's time-domain frame or its shared spectrum, depending on the algorithm
+        const vector<Real>& input = entry->inputType == FeatureSlotAlgorithm::SPECTRUM ? inputSpectrum : inputAudioBuffer;
+        newInstance = make_unique<AlgorithmInstance>();
+        newInstance->entry = entry;
+        newInstance->algorithm.reset(entry->create(input, newInstance->output, sampleRate, ANALYSIS_FRAME_SIZE));
     }
-    // Otherwise initialise with respective algorithm
-    if(algoStr == "Loudness"){
-        algorithm.reset(factory.create("Loudness"));
-        algorithm->input("signal").set(inputAudioBuffer);
-        algorithm->output("loudness").set(outputScalar);
+
+    // Swap in the new algorithm
+    auto* oldInstance = activeInstance.exchange(newInstance.release());
+    currentValue.store(0.0f);
+
+    // The old algorithm may still be in use by a computation that started before the swap
+    if(oldInstance != nullptr){
+        retiredInstances.push_back({ unique_ptr<AlgorithmInstance>(oldInstance), computeStarted.load() });
     }
-    if(algoStr == "Spectral Centroid"){
-        algorithm.reset(factory.create("SpectralCentroidTime", "sampleRate", (double) magicState.getPropertyAsValue("sampleRate").getValue()));
-        algorithm->input("array").set(inputAudioBuffer);
-        algorithm->output("centroid").set(outputScalar);
+    deleteRetiredInstances();
+}
+
+void FeatureSlotProcessor::reinitialise() {
+    rebuildRequested.store(true);
+    triggerAsyncUpdate();
+}
+
+void FeatureSlotProcessor::deleteRetiredInstances() {
+    // Computations run one after another on the analysis thread, so once as many have finished as had been started
+    // at the time of the swap, none of them can still be using the retired instance
+    const auto finished = computeFinished.load();
+    retiredInstances.erase(remove_if(retiredInstances.begin(), retiredInstances.end(),
+                                     [finished](const RetiredInstance& retired){ return retired.computeTicket <= finished; }),
+                           retiredInstances.end());
+
+    // A single computation is still running, which finishes within a frame. Retry shortly instead of posting
+    // another async update right away, which would keep the message thread busy until it finished
+    if(!retiredInstances.empty()){
+        startTimer(FEATURE_SLOT_RETIRE_RETRY_MS);
     }
 }
 
@@ -72,48 +120,52 @@ Value &FeatureSlotProcessor::getOutputValue() {
     return outputValue;
 }
 
+void FeatureSlotProcessor::displayValue(float value) {
+    outputValue.setValue(value);
+}
+
 void FeatureSlotProcessor::parameterChanged(const String &parameterID, float newValue) {
+    // Parameter changes may arrive on any thread (e.g. host automation on the audio thread),
+    // so the algorithm is always built on the message thread
     if(parameterID == paramID){
-        // Block further computation calls while algorithm is changing
-        isAlgorithmChanging.store(true);
-        // Reset output value
-        currentValue = 0;
-
-        // Reset algorithm field if no algorithm selected
-        if(algorithm != nullptr){
-            algorithm->reset();
-            algorithm.reset(nullptr);
-        }
-
-        // Convert index from combobox items to int
-        int idx = static_cast<int>(newValue) + 1;
-        // If no item is selected don't initialise an algorithm
-        if(idx == 0){
-            isAlgorithmChanging.store(false);
-            return;
-        }
+        triggerAsyncUpdate();
+    }
+}
 
-        // Get name of algorithm
-        String algoName = featureSlotAlgorithmOptions.getReference(idx - 1);
-        // Update if a new algorithm was selected
-        if(currentAlgoString != algoName){
-            currentAlgoString = algoName;
-            initialiseAlgorithm(algoName);
-        }
+void FeatureSlotProcessor::applyPendingChanges() {
+    handleUpdateNowIfNeeded();
+}
 
-        // Reset flag and thereby re-enable computation
-        isAlgorithmChanging.store(false);
+void FeatureSlotProcessor::handleAsyncUpdate() {
+    // Get name of the selected algorithm
+    int idx = roundToInt(magicState.getValueTreeState().getRawParameterValue(paramID)->load());
+    String algoName = featureSlotAlgorithmOptions[idx];
+
+    // Update if a new algorithm was selected (or a rebuild was requested)
+    const auto rebuild = rebuildRequested.exchange(false);
+    if(rebuild || currentAlgoString != algoName){
+        initialiseAlgorithm(algoName);
+    } else if(!retiredInstances.empty()){
+        // Clean up algorithms that were swapped out
+        deleteRetiredInstances();
     }
 }
 
 void FeatureSlotProcessor::timerCallback() {
-    if(algorithm != nullptr && !isAlgorithmChanging.load()){
-        // Update the output value
-        outputValue.setValue(currentValue);
-
-        // Poll libmapper device
-        libmapperDevice.poll();
-        // Update signal value
-        sensor->update(currentValue);
+    // One-shot, deleteRetiredInstances() restarts it if needed
+    stopTimer();
+    deleteRetiredInstances();
+}
+
+bool FeatureSlotProcessor::getCurrentValue(float& value) const {
+    if(activeInstance.load() == nullptr){
+        return false;
     }
+    value = currentValue.load();
+    return true;
+}
+
+mapper::Signal& FeatureSlotProcessor::getSensor() {
+    jassert(sensor != nullptr);
+    return *sensor;
 }
@@ -10,6 +10,9 @@
 #include <mapper/mapper_cpp.h>
 #include "../foleys_gui_magic/foleys_gui_magic.h"
 #include "../Constants.h"
+#include "../Analysis/BandAnalysisGraph.h"
+#include "../Parameters/BandParameterIDs.h"
+#include "FeatureSlotAlgorithms.h"
 
 using namespace std;
 using namespace juce;
@@ -19,29 +22,41 @@ using namespace essentia::standard;
 /**
  * Backend for the FeatureSlot component.
  * Feature slots are used in the sub-bands. They can be configured to compute specific algorithms.
- * The underlying algorithm they compute can be changed at runtime.
+ * The underlying algorithm they compute can be changed at runtime: a new algorithm is built on the message thread and
+ * swapped in with an atomic pointer exchange. The previous one is deleted on the message thread once the analysis
+ * thread is guaranteed to no longer use it, so compute() never waits, allocates or touches a deleted algorithm.
+ * The slot doesn't poll: the processor displays its value with every GUI update (see displayValue()), and retired
+ * algorithms are cleaned up after a swap, retried by a one-shot timer while a computation still uses them.
  */
-class FeatureSlotProcessor : private AudioProcessorValueTreeState::Listener, Timer {
+class FeatureSlotProcessor : private AudioProcessorValueTreeState::Listener, AsyncUpdater, Timer {
 public:
 
     /**
-     * Enum for indicating the sub-band the FeatureSlot is assigned to
+     * @param libmapperDevice Device the slot's signal is added to, nullptr for no signal (e.g. offline analysis)
+     * @param band Index of the sub-band the FeatureSlot is assigned to, 0 being the lowest
+     * @param bandGraph Shared input of that sub-band
+     * @param slotNo Number of the slot within its sub-band, starting at 1
      */
-    enum Band {
-        LOW,
-        MID,
-        HIGH
-    };
-
-    FeatureSlotProcessor(mapper::Device&, foleys::MagicProcessorState&, Band, vector<Real>&, int);
+    FeatureSlotProcessor(mapper::Device* libmapperDevice, foleys::MagicProcessorState&, int band, BandAnalysisGraph& bandGraph, int slotNo);
     ~FeatureSlotProcessor();
 
     /**
-     * Initialise one of the available Essentia algorithms
-     * @param algoStr The Essentia descriptor of the algorithm, e.g. "SpectralCentroidTime" for the spectral centroid
+     * Initialise one of the available Essentia algorithms and swap it in. Must be called on the message thread.
+     * @param algoStr The name of the algorithm in the FeatureSlotAlgorithms registry, e.g. "Spectral Centroid"
      */
     void initialiseAlgorithm(String algoStr);
 
+    /**
+     * Rebuild the current algorithm asynchronously on the message thread, e.g. after the analysis sample rate changed
+     */
+    void reinitialise();
+
+    /**
+     * Apply a pending algorithm change or rebuild right away instead of waiting for the message loop
+     * (e.g. for offline analysis). Must be called on the message thread.
+     */
+    void applyPendingChanges();
+
     /**
      * Getter for the current output value of the currently selected algorithm
      * @return
@@ -49,52 +64,94 @@ public:
     Value& getOutputValue();
 
     /**
-     * Performs the computation of the selected algorithm using the currently available input data (see field inputAudioBuffer)
+     * Display a published value of this slot in the GUI. Must be called on the message thread.
+     * @param value Value of the slot in the most recent analysis frame
+     */
+    void displayValue(float value);
+
+    /**
+     * Performs the computation of the selected algorithm using the currently available input data
+     * (see fields inputAudioBuffer and inputSpectrum). The band's spectrum is computed first if the algorithm reads it.
      */
     void compute();
 
     /**
-     * Timer callback that performs the computation if an algorithm is selected
+     * Lock-free read of the most recent computation result, used for publishing it over libmapper
+     * @param value Set to the most recent result
+     * @return false if no algorithm is selected
      */
-    void timerCallback() override;
+    bool getCurrentValue(float& value) const;
+
+    // Libmapper signal of this FeatureSlot, only valid if it was created with a device. Only updated by the publisher thread
+    mapper::Signal& getSensor();
+
+    /**
+     * Builds and swaps in the selected algorithm on the message thread after a parameter change, and deletes
+     * retired algorithms once the analysis thread no longer uses them
+     */
+    void handleAsyncUpdate() override;
 
 private:
     // State management
     foleys::MagicProcessorState& magicState;
     String paramID = "";
 
-    // Essentia identifier of the current algorithm
+    // Registry name of the current algorithm
     String currentAlgoString = "";
+    // Set by reinitialise() to rebuild even if the selected algorithm didn't change
+    atomic<bool> rebuildRequested = ATOMIC_VAR_INIT(false);
 
+    // Shared analysis state of the band, only used by the analysis thread
+    BandAnalysisGraph& bandGraph;
     // The input buffer for this slot
     const vector<Real>& inputAudioBuffer;
+    // The spectrum of the input buffer, shared between all slots of the band
+    const vector<Real>& inputSpectrum;
 
-    // This field will contain the output if the output is a scalar value
-    Real outputScalar = -1.0f;
     // This field will contain the output value
     Value outputValue;
 
-    // Important: Placeholder for the most recent computation result, which is updated by a timed function in order
-    // to avoid GUI update calls from the audio thread
-    float currentValue = 0.0f;
+    // Most recent computation result, published with the analysis frame. The GUI is updated from the published
+    // frame on the message thread, never from the analysis thread
+    atomic<float> currentValue = ATOMIC_VAR_INIT(0.0f);
 
-    // Factory for creating the algorithm
-    standard::AlgorithmFactory& factory = standard::AlgorithmFactory::instance();
+    /**
+     * An Essentia algorithm together with its registry entry and the storage it writes its outputs to.
+     * Instances are built on the message thread and handed to the analysis thread as a whole.
+     */
+    struct AlgorithmInstance {
+        const FeatureSlotAlgorithm* entry = nullptr;
+        unique_ptr<Algorithm> algorithm;
+        FeatureSlotOutput output;
+    };
 
-    // The Essentia algorithm object for this slot
-    unique_ptr<Algorithm> algorithm;
+    /**
+     * An instance that was swapped out, together with the number of computations started at the time of the swap
+     */
+    struct RetiredInstance {
+        unique_ptr<AlgorithmInstance> instance;
+        uint64 computeTicket;
+    };
 
-    // Flag indicating whether the algorithm is currently being changed
-    // Important to handle calls to the compute() function while the algorithm is in the process of changing
-    atomic<bool> isAlgorithmChanging = ATOMIC_VAR_INIT(false);
+    // Algorithm used by compute(), owned by this object. nullptr if no algorithm is selected
+    atomic<AlgorithmInstance*> activeInstance = ATOMIC_VAR_INIT(nullptr);
+    // Number of started and finished compute() calls, used to tell when a retired instance is no longer in use
+    atomic<uint64> computeStarted = ATOMIC_VAR_INIT(0);
+    atomic<uint64> computeFinished = ATOMIC_VAR_INIT(0);
+    // Instances waiting for deletion, only accessed on the message thread
+    vector<RetiredInstance> retiredInstances;
+
+    // Delete all retired instances the analysis thread can no longer be using (message thread)
+    // Schedules another attempt if a computation that started before the swap is still running
+    void deleteRetiredInstances();
+    // Retries deleteRetiredInstances() after FEATURE_SLOT_RETIRE_RETRY_MS
+    void timerCallback() override;
 
-    // Reference to the main libmapper device
-    mapper::Device& libmapperDevice;
-    // Libmapper signal for this FeatureSlot
+    // Libmapper signal for this FeatureSlot, nullptr without a device
     unique_ptr<mapper::Signal> sensor;
 
-    // Indicator of the sub-band of the FeatureSlot
-    Band band = LOW;
+    // Index of the sub-band of the FeatureSlot
+    int band = 0;
     // Indicator of the number of the slot in its respective sub-band
     int slotNumber = -1;
 
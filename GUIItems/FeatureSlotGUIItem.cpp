@@ -8,9 +8,7 @@
 FeatureSlotGUIItem::FeatureSlotGUIItem(foleys::MagicGUIBuilder& builder, const juce::ValueTree& node)
         :foleys::GuiItem (builder, node),
         magicState(dynamic_cast<AudioPluginAudioProcessor*>(builder.getMagicState().getProcessor())->getMagicState()),
-        lowBandSlots(dynamic_cast<AudioPluginAudioProcessor*>(builder.getMagicState().getProcessor())->getLowBandSlots()),
-        midBandSlots(dynamic_cast<AudioPluginAudioProcessor*>(builder.getMagicState().getProcessor())->getMidBandSlots()),
-        highBandSlots(dynamic_cast<AudioPluginAudioProcessor*>(builder.getMagicState().getProcessor())->getHighBandSlots())
+        bandSlots(dynamic_cast<AudioPluginAudioProcessor*>(builder.getMagicState().getProcessor())->getBandSlots())
         {
     if (auto* proc = dynamic_cast<AudioPluginAudioProcessor*>(builder.getMagicState().getProcessor()))
     {
@@ -24,17 +22,13 @@ void FeatureSlotGUIItem::update() {
     if(!val.isVoid()){
         String valStr = val.toString();
 
-        // Get current slot number
-        char slot = valStr.toStdString().back();
-        int slotNo = slot - '0';
+        // Get band and slot number from the parameter ID, e.g. "band2Slot1"
+        int band = valStr.fromFirstOccurrenceOf("band", false, false).upToFirstOccurrenceOf("Slot", false, false).getIntValue() - 1;
+        int slotNo = valStr.fromLastOccurrenceOf("Slot", false, false).getIntValue();
 
         // Add feature slots to vector for access in processor
-        if(valStr.contains("low")) {
-            featureSlotGUI->registerValue(lowBandSlots[slotNo - 1]->getOutputValue());
-        } else if(valStr.contains("mid")){
-            featureSlotGUI->registerValue(midBandSlots[slotNo - 1]->getOutputValue());
-        } else if(valStr.contains("high")){
-            featureSlotGUI->registerValue(highBandSlots[slotNo - 1]->getOutputValue());
+        if(isPositiveAndBelow(band, static_cast<int>(bandSlots.size())) && isPositiveAndBelow(slotNo - 1, static_cast<int>(bandSlots[band].size()))) {
+            featureSlotGUI->registerValue(bandSlots[band][slotNo - 1]->getOutputValue());
         }
 
         // Lastly, attach to value
@@ -42,10 +42,8 @@ public:
     }
 
 private:
-    // References to the FeatureSlotProcessors for each sub-band
-    vector<unique_ptr<FeatureSlotProcessor>>& lowBandSlots;
-    vector<unique_ptr<FeatureSlotProcessor>>& midBandSlots;
-    vector<unique_ptr<FeatureSlotProcessor>>& highBandSlots;
+    // References to the FeatureSlotProcessors, one vector per sub-band
+    vector<vector<unique_ptr<FeatureSlotProcessor>>>& bandSlots;
     // Pointer to the wrapped FeatureSlotGUI instance object
     unique_ptr<FeatureSlotGUI> featureSlotGUI;
     // State management
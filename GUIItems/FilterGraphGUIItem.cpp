@@ -19,5 +19,10 @@ FilterGraphGUIItem::FilterGraphGUIItem(foleys::MagicGUIBuilder& builder, const j
 }
 
 void FilterGraphGUIItem::update() {
-
+    // The processor's sample rate may have changed since the graph was created
+    if (auto* proc = dynamic_cast<AudioPluginAudioProcessor*>(magicBuilder.getMagicState().getProcessor()))
+    {
+        if (filterGraph != nullptr)
+            filterGraph->setSampleRate(proc->getSampleRate());
+    }
 }
@@ -0,0 +1,142 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include <iostream>
+#include "OfflineAnalysisJob.h"
+
+using namespace std;
+using namespace juce;
+
+static void printUsage() {
+    cout << "Usage: music-vis-backend-offline [options] <audio file>...\n"
+            "Writes the analysis frames of each file to <file name>.features.csv\n\n"
+            "Options:\n"
+            "  --bands=<n>                      Number of bands (1-" << MAX_NUMBER_OF_BANDS << ", default 1)\n"
+            "  --low=<Hz>                       Lowest crossover frequency (default 60)\n"
+            "  --high=<Hz>                      Highest crossover frequency (default 8000)\n"
+            "  --source=left|right|mono|mid|side Analysed signal (default mono)\n"
+            "  --slot=<band>:<slot>=<algorithm> FeatureSlot algorithm, band and slot start at 1 (repeatable)\n"
+            "  --vectors                        Also write the log spectrum and the mel bands\n"
+            "  --output=<folder>                Output folder (default: next to the input file)\n"
+            "  --threads=<n>                    Number of files analysed in parallel (default: number of cores)\n"
+            "  --help                           Show this message\n\n"
+            "Algorithms: " << featureSlotAlgorithmOptions.joinIntoString(", ") << endl;
+}
+
+// Parse "--slot=<band>:<slot>=<algorithm>" into the settings, returns false if it's invalid
+static bool parseSlot(const String& value, OfflineAnalysisSettings& settings) {
+    const auto position = value.upToFirstOccurrenceOf("=", false, false);
+    const auto algorithm = value.fromFirstOccurrenceOf("=", false, false);
+    const auto band = position.upToFirstOccurrenceOf(":", false, false).getIntValue() - 1;
+    const auto slot = position.fromFirstOccurrenceOf(":", false, false).getIntValue() - 1;
+
+    if(band < 0 || band >= MAX_NUMBER_OF_BANDS || slot < 0 || slot >= NUMBER_OF_SLOTS
+       || !featureSlotAlgorithmOptions.contains(algorithm)){
+        return false;
+    }
+    // "-" clears the slot
+    settings.slotAlgorithms[FeatureFrame::getSlotIndex(band, slot)] = algorithm == featureSlotAlgorithmOptions[0] ? String() : algorithm;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    ArgumentList arguments(argc, argv);
+    if(arguments.size() == 0 || arguments.containsOption("--help|-h")){
+        printUsage();
+        return arguments.size() == 0 ? 1 : 0;
+    }
+
+    // The processor and its parameters need the message manager
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    OfflineAnalysisSettings settings;
+    File outputFolder;
+    int numThreads = SystemStats::getNumCpuCores();
+    Array<File> inputFiles;
+
+    for (const auto& argument : arguments.arguments){
+        const auto text = argument.text;
+        const auto value = text.fromFirstOccurrenceOf("=", false, false);
+
+        if(text.startsWith("--bands=")){
+            settings.numberOfBands = value.getIntValue();
+            if(settings.numberOfBands < 1 || settings.numberOfBands > MAX_NUMBER_OF_BANDS){
+                cerr << "Invalid number of bands: " << value << endl;
+                return 1;
+            }
+        } else if(text.startsWith("--low=")){
+            settings.lowestCrossover = value.getFloatValue();
+        } else if(text.startsWith("--high=")){
+            settings.highestCrossover = value.getFloatValue();
+        } else if(text.startsWith("--source=")){
+            const auto index = StringArray("left", "right", "mono", "mid", "side").indexOf(value, true);
+            if(index < 0){
+                cerr << "Invalid source: " << value << endl;
+                return 1;
+            }
+            settings.source = static_cast<AnalysisWorker::Source>(index);
+        } else if(text.startsWith("--slot=")){
+            if(!parseSlot(value, settings)){
+                cerr << "Invalid slot: " << value << endl;
+                return 1;
+            }
+        } else if(text == "--vectors"){
+            settings.writeVectors = true;
+        } else if(text.startsWith("--output=")){
+            outputFolder = File::getCurrentWorkingDirectory().getChildFile(value);
+        } else if(text.startsWith("--threads=")){
+            numThreads = jmax(1, value.getIntValue());
+        } else if(argument.isOption()){
+            cerr << "Unknown option: " << text << endl;
+            return 1;
+        } else {
+            inputFiles.add(argument.resolveAsFile());
+        }
+    }
+
+    if(outputFolder != File() && !outputFolder.createDirectory()){
+        cerr << "Could not create " << outputFolder.getFullPathName() << endl;
+        return 1;
+    }
+
+    int numFailed = 0;
+    // Work queue: each file gets its own processor and thread, at most numThreads run at once and the next file is
+    // started as soon as any of them finished. The processors are created and deleted here on the message thread.
+    WaitableEvent jobFinished;
+    OwnedArray<OfflineAnalysisJob> runningJobs;
+    Array<File> runningFiles;
+    int nextFile = 0;
+    while (nextFile < inputFiles.size() || !runningJobs.isEmpty()){
+        while (nextFile < inputFiles.size() && runningJobs.size() < numThreads){
+            const auto& inputFile = inputFiles.getReference(nextFile++);
+            const auto folder = outputFolder == File() ? inputFile.getParentDirectory() : outputFolder;
+            auto* job = runningJobs.add(new OfflineAnalysisJob(inputFile,
+                                                               folder.getChildFile(inputFile.getFileNameWithoutExtension() + ".features.csv"),
+                                                               settings, &jobFinished));
+            runningFiles.add(inputFile);
+            job->startThread();
+        }
+
+        jobFinished.wait(-1);
+
+        for (int i = runningJobs.size(); --i >= 0;){
+            auto* job = runningJobs[i];
+            if(!job->hasFinished()){
+                continue;
+            }
+            job->waitForThreadToExit(-1);
+            const auto& inputFile = runningFiles.getReference(i);
+            if(job->wasSuccessful()){
+                cout << "Analysed " << inputFile.getFullPathName() << endl;
+            } else {
+                cerr << "Failed " << inputFile.getFullPathName() << ": " << job->getErrorMessage() << endl;
+                numFailed++;
+            }
+            runningJobs.remove(i);
+            runningFiles.remove(i);
+        }
+    }
+
+    return numFailed == 0 ? 0 : 1;
+}
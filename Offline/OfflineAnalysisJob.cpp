@@ -0,0 +1,180 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "OfflineAnalysisJob.h"
+
+OfflineAnalysisJob::OfflineAnalysisJob(const File& inputFile, const File& outputFile,
+                                       const OfflineAnalysisSettings& settings, WaitableEvent* finishedEvent)
+        : Thread("music-vis-backend offline"), inputFile(inputFile), outputFile(outputFile), settings(settings),
+          finishedEvent(finishedEvent) {
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    reader.reset(formatManager.createReaderFor(inputFile));
+    if(reader == nullptr){
+        errorMessage = "Unsupported or unreadable audio file: " + inputFile.getFullPathName();
+        return;
+    }
+
+    processor = make_unique<AudioPluginAudioProcessor>(AudioPluginAudioProcessor::OFFLINE);
+
+    // Parameters are set as in the plugin, so the listeners set up the crossover and the FeatureSlots
+    // The cutoffs go before the band count: in 2-band mode the processor copies the highpass into the lowpass cutoff,
+    // so only the lowest crossover is set there
+    setParameter("lowpassCutoff", settings.lowestCrossover);
+    if(settings.numberOfBands != 2){
+        setParameter("highpassCutoff", settings.highestCrossover);
+    }
+    setParameter("numberOfBands", static_cast<float>(settings.numberOfBands - 1));
+    setParameter("analysisSource", static_cast<float>(settings.source));
+    for (int band = 0; band < settings.numberOfBands; band++){
+        for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++){
+            const auto& name = settings.slotAlgorithms[FeatureFrame::getSlotIndex(band, slot)];
+            if(name.isNotEmpty()){
+                setParameter(getBandSlotID(band, slot + 1),
+                             static_cast<float>(featureSlotAlgorithmOptions.indexOf(name)));
+            }
+        }
+    }
+
+    worker = &processor->prepareForOfflineAnalysis(reader->sampleRate, OFFLINE_BLOCK_SIZE);
+    worker->getFrameNotifier().addListener(this);
+}
+
+OfflineAnalysisJob::~OfflineAnalysisJob() {
+    stopThread(-1);
+    if(worker != nullptr){
+        worker->getFrameNotifier().removeListener(this);
+    }
+}
+
+void OfflineAnalysisJob::run() {
+    analyseFile();
+
+    finished.store(true);
+    if(finishedEvent != nullptr){
+        finishedEvent->signal();
+    }
+}
+
+void OfflineAnalysisJob::analyseFile() {
+    if(worker == nullptr){
+        return;
+    }
+
+    outputFile.deleteFile();
+    output = make_unique<FileOutputStream>(outputFile);
+    if(output->failedToOpen()){
+        errorMessage = "Could not write " + outputFile.getFullPathName() + ": " + output->getStatus().getErrorMessage();
+        return;
+    }
+    writeHeader();
+
+    AudioBuffer<float> buffer(2, OFFLINE_BLOCK_SIZE);
+    const auto isStereo = reader->numChannels > 1;
+    for (int64 startSample = 0; startSample < reader->lengthInSamples; startSample += OFFLINE_BLOCK_SIZE){
+        if(threadShouldExit()){
+            errorMessage = "Cancelled";
+            return;
+        }
+
+        const auto numSamples = static_cast<int>(jmin(static_cast<int64>(OFFLINE_BLOCK_SIZE), reader->lengthInSamples - startSample));
+        if(!reader->read(&buffer, 0, numSamples, startSample, true, isStereo)){
+            errorMessage = "Could not read " + inputFile.getFullPathName();
+            return;
+        }
+
+        // Frames are written from analysisFrameReady() while analysing
+        const auto* left = buffer.getReadPointer(0);
+        worker->analyse(left, isStereo ? buffer.getReadPointer(1) : left, numSamples, settings.source);
+    }
+
+    output->flush();
+    if(output->getStatus().failed()){
+        errorMessage = "Could not write " + outputFile.getFullPathName() + ": " + output->getStatus().getErrorMessage();
+        return;
+    }
+    successful = true;
+}
+
+bool OfflineAnalysisJob::hasFinished() const {
+    return finished.load();
+}
+
+bool OfflineAnalysisJob::wasSuccessful() const {
+    return successful;
+}
+
+String OfflineAnalysisJob::getErrorMessage() const {
+    return errorMessage;
+}
+
+void OfflineAnalysisJob::analysisFrameReady() {
+    worker->readFeatureFrame(frame);
+
+    // The host position is the position in the file, the timestamp the time of the frame's centre in the file
+    String line;
+    line << String(frame.frameNumber) << ","
+         << String(frame.hostSamplePosition) << ","
+         << String(frame.timeMs / 1000.0, 6) << ","
+         << String(frame.spectralCentroid) << ","
+         << String(frame.pitchYIN) << ","
+         << String(frame.pitchConfidence) << ","
+         << String(frame.loudness) << ","
+         << String(frame.onsetDetection) << ","
+         << String(frame.dissonance);
+
+    for (int band = 0; band < settings.numberOfBands; band++){
+        for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++){
+            const auto index = FeatureFrame::getSlotIndex(band, slot);
+            if(settings.slotAlgorithms[index].isEmpty()){
+                continue;
+            }
+            line << ",";
+            if(frame.slotActive[index]){
+                line << String(frame.slotValues[index]);
+            }
+        }
+    }
+
+    if(settings.writeVectors){
+        for (auto value : frame.spectrum){
+            line << "," << String(value);
+        }
+        for (auto value : frame.melBands){
+            line << "," << String(value);
+        }
+    }
+
+    *output << line << "\n";
+}
+
+void OfflineAnalysisJob::setParameter(const String& parameterID, float value) {
+    auto* parameter = processor->getMagicState().getValueTreeState().getParameter(parameterID);
+    jassert(parameter != nullptr);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+void OfflineAnalysisJob::writeHeader() {
+    String header = "frame,samplePosition,seconds,spectralCentroid,pitchYIN,pitchConfidence,loudness,onsetDetection,dissonance";
+
+    for (int band = 0; band < settings.numberOfBands; band++){
+        for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++){
+            const auto& name = settings.slotAlgorithms[FeatureFrame::getSlotIndex(band, slot)];
+            if(name.isNotEmpty()){
+                header << ",band" << String(band + 1) << "_slot" << String(slot + 1) << "_" << name.removeCharacters(" ,");
+            }
+        }
+    }
+
+    if(settings.writeVectors){
+        for (int bin = 0; bin < SPECTRUM_PUBLISH_BINS; bin++){
+            header << ",spectrum_" << String(bin);
+        }
+        for (int band = 0; band < NUMBER_OF_MEL_BANDS; band++){
+            header << ",mel_" << String(band);
+        }
+    }
+
+    *output << header << "\n";
+}
@@ -0,0 +1,83 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_OFFLINEANALYSISJOB_H
+#define MUSIC_VIS_BACKEND_OFFLINEANALYSISJOB_H
+
+#include "../PluginProcessor.h"
+
+using namespace std;
+using namespace juce;
+
+/**
+ * Settings of an offline analysis, mirroring the plugin's parameters
+ */
+struct OfflineAnalysisSettings {
+    int numberOfBands = 1;
+    float lowestCrossover = 60.0f;
+    float highestCrossover = 8000.0f;
+    AnalysisWorker::Source source = AnalysisWorker::MONO;
+    // Algorithm name (see FeatureSlotAlgorithms) per slot, indexed by FeatureFrame::getSlotIndex()
+    array<String, MAX_NUMBER_OF_BANDS * NUMBER_OF_SLOTS> slotAlgorithms;
+    // Whether the log spectrum and the mel bands are written as well
+    bool writeVectors = false;
+};
+
+/**
+ * Renders the feature timeline of one audio file on its own thread.
+ * The job owns a processor, so the file runs through exactly the same analysis chain as in the plugin. The processor
+ * is created and configured on the message thread, the file is then streamed through the analysis in blocks of
+ * OFFLINE_BLOCK_SIZE samples. Every analysis frame is written as one line of a CSV file.
+ */
+class OfflineAnalysisJob : public Thread, private AnalysisFrameNotifier::Listener {
+public:
+    /**
+     * Create and configure the processor. Must be called on the message thread.
+     * @param finishedEvent Signalled when the job's thread finished, may be nullptr
+     */
+    OfflineAnalysisJob(const File& inputFile, const File& outputFile, const OfflineAnalysisSettings& settings,
+                       WaitableEvent* finishedEvent = nullptr);
+    ~OfflineAnalysisJob() override;
+
+    void run() override;
+
+    // Whether the job's thread is done with the file, successfully or not
+    bool hasFinished() const;
+    // Whether the file was analysed completely, only valid after the thread finished
+    bool wasSuccessful() const;
+    // Description of the failure, if any
+    String getErrorMessage() const;
+
+private:
+    // Stream the file through the analysis, called by run()
+    void analyseFile();
+
+    // Write the current frame, called on the job's thread for every frame
+    void analysisFrameReady() override;
+
+    // Set a parameter of the processor to a (denormalised) value
+    void setParameter(const String& parameterID, float value);
+
+    void writeHeader();
+
+    File inputFile, outputFile;
+    OfflineAnalysisSettings settings;
+
+    unique_ptr<AudioFormatReader> reader;
+    unique_ptr<AudioPluginAudioProcessor> processor;
+    AnalysisWorker* worker = nullptr;
+
+    unique_ptr<FileOutputStream> output;
+    FeatureFrame frame;
+
+    bool successful = false;
+    String errorMessage;
+    atomic<bool> finished { false };
+    WaitableEvent* finishedEvent = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OfflineAnalysisJob)
+};
+
+
+#endif //MUSIC_VIS_BACKEND_OFFLINEANALYSISJOB_H
@@ -0,0 +1,47 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_BANDPARAMETERIDS_H
+#define MUSIC_VIS_BACKEND_BANDPARAMETERIDS_H
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+// Identifiers of the per-band parameters and GUI properties
+// Bands are indexed from 0 (lowest band) in code and numbered from 1 in the identifiers, e.g. "band1Slot2"
+
+// Solo toggle of a band
+inline String getBandSoloID(int band){
+    return "band" + String(band + 1) + "Solo";
+}
+
+// Algorithm selector of a FeatureSlot, slotNumber starts at 1
+inline String getBandSlotID(int band, int slotNumber){
+    return "band" + String(band + 1) + "Slot" + String(slotNumber);
+}
+
+// GUI property indicating whether a band is in use with the current number of bands
+inline String getBandEnabledID(int band){
+    return "band" + String(band + 1) + "Enabled";
+}
+
+// Current identifier of a parameter saved before the bands were numbered ("lowSolo", "midSlot2", ...)
+// Returns an empty string if the identifier isn't one of the legacy low, mid and high band parameters
+inline String getMigratedBandParameterID(const String& legacyID){
+    const StringArray legacyBandNames { "low", "mid", "high" };
+    for (int band = 0; band < legacyBandNames.size(); band++){
+        const auto slotPrefix = legacyBandNames[band] + "Slot";
+        if(legacyID == legacyBandNames[band] + "Solo"){
+            return getBandSoloID(band);
+        }
+        const auto slotNumber = legacyID.fromFirstOccurrenceOf(slotPrefix, false, false);
+        if(legacyID.startsWith(slotPrefix) && slotNumber.isNotEmpty() && slotNumber.containsOnly("0123456789")){
+            return getBandSlotID(band, slotNumber.getIntValue());
+        }
+    }
+    return {};
+}
+
+#endif //MUSIC_VIS_BACKEND_BANDPARAMETERIDS_H
@@ -5,8 +5,7 @@
 
 //==============================================================================
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAudioProcessor& p, AudioProcessorValueTreeState& valueTreeState)
-    : AudioProcessorEditor (&p), processorRef (p), spectrum(p.getSpectrumData()),
-    spectralCentroid(p.getSpectralCentroid()), vts(valueTreeState)
+    : AudioProcessorEditor (&p), processorRef (p), vts(valueTreeState)
 {
     // Hook up to state management
     vts.addParameterListener("numberOfBands", this);
@@ -28,9 +28,6 @@ private:
     // Audio parameters
     atomic<float>* numberOfBands;
 
-    vector<Real>& spectrum;
-    Real& spectralCentroid;
-
     // GUI elements
     unique_ptr<ComboBox> cbNumberOfBands;
     // The filter visualisation component
@@ -1,7 +1,11 @@
 #include "PluginProcessor.h"
 
+// Number of processors using essentia, only changed on the message thread. Essentia's init and shutdown are global, so
+// the last processor to be deleted shuts it down.
+static int numEssentiaUsers = 0;
+
 //==============================================================================
-AudioPluginAudioProcessor::AudioPluginAudioProcessor()
+AudioPluginAudioProcessor::AudioPluginAudioProcessor(Mode processorMode)
      : AudioProcessor (BusesProperties()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
@@ -9,157 +13,138 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
 #endif
-                       ), valueTreeState(*this,
+                       ), mode(processorMode), valueTreeState(*this,
                          nullptr, // No undo manager
                          Identifier("music-vis-backend"),
-                         {
-                           make_unique<MetaParameterChoice>(
-                                    "numberOfBands",
-                                    "Number of Bands",
-                                    StringArray("1", "2", "3"), // Support max 3 bands atm
-                                    0
-                            ),
-                            make_unique<MetaParameterFloat>(
-                                    "lowpassCutoff",
-                                    "Lowpass Filter Cutoff",
-                                    20.0f,
-                                    20000.0f,
-                                    3000.0f
-                                    ),
-                           make_unique<MetaParameterFloat>(
-                                   "highpassCutoff",
-                                   "Highpass Filter Cutoff",
-                                   20.0f,
-                                   20000.0f,
-                                   5000.0f
-                           ),
-                           make_unique<AudioParameterBool>(
-                                   "lowSolo",
-                                   "Low Band Solo",
-                                   false
-                                   ),
-                           make_unique<AudioParameterBool>(
-                                   "midSolo",
-                                   "Mid Band Solo",
-                                   false
-                           ),
-                           make_unique<AudioParameterBool>(
-                                 "highSolo",
-                                 "High Band Solo",
-                                 false
-                         ),
-                         // Sub band algorithm slot selectors
-                         // Low band
-                           make_unique<AudioParameterChoice>(
-                                   "lowSlot1",
-                                   "Low Band Slot 1 Algorithm",
-                                   featureSlotAlgorithmOptions,
-                                   0
-                           ),
-                           make_unique<AudioParameterChoice>(
-                                   "lowSlot2",
-                                   "Low Band Slot 2 Algorithm",
-                                   featureSlotAlgorithmOptions,
-                                   0
-                           ),
-                           // Mid band
-                           make_unique<AudioParameterChoice>(
-                                   "midSlot1",
-                                   "Mid Band Slot 1 Algorithm",
-                                   featureSlotAlgorithmOptions,
-                                   0
-                           ),
-                           make_unique<AudioParameterChoice>(
-                                   "midSlot2",
-                                   "Mid Band Slot 2 Algorithm",
-                                   featureSlotAlgorithmOptions,
-                                   0
-                           ),
-                           // High band
-                           make_unique<AudioParameterChoice>(
-                                   "highSlot1",
-                                   "High Band Slot 1 Algorithm",
-                                   featureSlotAlgorithmOptions,
-                                   0
-                           ),
-                           make_unique<AudioParameterChoice>(
-                                   "highSlot2",
-                                   "High Band Slot 2 Algorithm",
-                                   featureSlotAlgorithmOptions,
-                                   0
-                           ),
-                           // Automatables
-                           make_unique<AudioParameterFloat>(
-                                   "auto1",
-                                   "Automatable 1",
-                                   0.0f,
-                                   1.0f,
-                                   0.0f
-                                   ),
-                           make_unique<AudioParameterFloat>(
-                                   "auto2",
-                                   "Automatable 2",
-                                   0.0f,
-                                   1.0f,
-                                   0.0f
-                           ),
-                           make_unique<AudioParameterFloat>(
-                                   "auto3",
-                                   "Automatable 3",
-                                   0.0f,
-                                   1.0f,
-                                   0.0f
-                           ),
-                           make_unique<AudioParameterFloat>(
-                                   "auto4",
-                                   "Automatable 4",
-                                   0.0f,
-                                   1.0f,
-                                   0.0f
-                           ),
-                           make_unique<AudioParameterFloat>(
-                                   "auto5",
-                                   "Automatable 5",
-                                   0.0f,
-                                   1.0f,
-                                   0.0f
-                           )
-                         })
+                         createParameterLayout())
 {
     // Initialise listeners for parameters
     magicState.getValueTreeState().addParameterListener("numberOfBands", this);
     magicState.getValueTreeState().addParameterListener("lowpassCutoff", this);
     magicState.getValueTreeState().addParameterListener("highpassCutoff", this);
-    magicState.getValueTreeState().addParameterListener("lowSolo", this);
-    magicState.getValueTreeState().addParameterListener("midSolo", this);
-    magicState.getValueTreeState().addParameterListener("highSolo", this);
 
     // Hook up parameters to values
     paramNumberOfBands = magicState.getValueTreeState().getRawParameterValue("numberOfBands");
-    paramLowpassCutoff.referTo(magicState.getValueTreeState().getParameterAsValue("lowpassCutoff"));
-    paramHighpassCutoff.referTo(magicState.getValueTreeState().getParameterAsValue("highpassCutoff"));
-    paramLowSolo = magicState.getValueTreeState().getRawParameterValue("lowSolo");
-    paramMidSolo = magicState.getValueTreeState().getRawParameterValue("midSolo");
-    paramHighSolo = magicState.getValueTreeState().getRawParameterValue("highSolo");
+    paramLowpassCutoff = magicState.getValueTreeState().getRawParameterValue("lowpassCutoff");
+    paramHighpassCutoff = magicState.getValueTreeState().getRawParameterValue("highpassCutoff");
+    paramAnalysisSource = magicState.getValueTreeState().getRawParameterValue("analysisSource");
+    paramBandMonitoring = magicState.getValueTreeState().getRawParameterValue("bandMonitoring");
+    paramPublishTimings = magicState.getValueTreeState().getRawParameterValue("publishTimings");
+    for (int band = 0; band < MAX_NUMBER_OF_BANDS; band++){
+        paramBandSolos.emplace_back(magicState.getValueTreeState().getRawParameterValue(getBandSoloID(band)));
+    }
     for (int i = 0; i < NUMBER_OF_AUTOMATABLES; i++){
         string name = "auto";
         name.append(to_string(i + 1));
         autoParams.emplace_back(magicState.getValueTreeState().getRawParameterValue(name));
-        // Add parameter listener
-        magicState.getValueTreeState().addParameterListener(name, this);
     }
 
-    // Initialise essentia
-    essentia::init();
+    // Initialise essentia, it is shared by all processors in the process
+    if(!essentia::isInitialized()){
+        essentia::init();
+    }
+    numEssentiaUsers++;
+
+    // Create the analysis thread before the FeatureSlots, which read from its sub-band graphs
+    analysisWorker = make_unique<AnalysisWorker>(bandSlots);
+    if(mode == REALTIME){
+        // The GUI is only updated when new results are available
+        analysisWorker->getFrameNotifier().addListener(this);
+
+        // Setup libmapper
+        libmapperSetup("music-vis-backend-libmapper");
+    } else {
+        // Every offline job has its own processor, none of them registers a device on the network
+        createFeatureSlots(nullptr);
+    }
+}
+
+AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::createParameterLayout() {
+    AudioProcessorValueTreeState::ParameterLayout layout;
 
-    // Setup libmapper
-    libmapperSetup("music-vis-backend-libmapper");
+    StringArray numberOfBandsChoices;
+    for (int i = 1; i <= MAX_NUMBER_OF_BANDS; i++){
+        numberOfBandsChoices.add(String(i));
+    }
+    layout.add(make_unique<MetaParameterChoice>(
+            "numberOfBands",
+            "Number of Bands",
+            numberOfBandsChoices,
+            0
+    ));
+    // Lowest and highest crossover frequency, the crossovers in between are spaced logarithmically
+    layout.add(make_unique<MetaParameterFloat>(
+            "lowpassCutoff",
+            "Lowpass Filter Cutoff",
+            20.0f,
+            20000.0f,
+            60.0f
+    ));
+    layout.add(make_unique<MetaParameterFloat>(
+            "highpassCutoff",
+            "Highpass Filter Cutoff",
+            20.0f,
+            20000.0f,
+            8000.0f
+    ));
+    layout.add(make_unique<AudioParameterChoice>(
+            "analysisSource",
+            "Analysis Source",
+            StringArray("Left", "Right", "Mono", "Mid", "Side"),
+            AnalysisWorker::MONO
+    ));
+    // Off: analysis only, the host audio passes through untouched
+    // On: soloed bands replace the output for monitoring
+    layout.add(make_unique<AudioParameterBool>(
+            "bandMonitoring",
+            "Band Monitoring",
+            false
+    ));
+    // Publish the analysis timings as libmapper debug signals
+    layout.add(make_unique<AudioParameterBool>(
+            "publishTimings",
+            "Publish Timings",
+            false
+    ));
+
+    // Per band solo toggles and algorithm slot selectors
+    for (int band = 0; band < MAX_NUMBER_OF_BANDS; band++){
+        const auto bandName = "Band " + String(band + 1);
+        layout.add(make_unique<AudioParameterBool>(
+                getBandSoloID(band),
+                bandName + " Solo",
+                false
+        ));
+        for (int slot = 1; slot <= NUMBER_OF_SLOTS; slot++){
+            layout.add(make_unique<AudioParameterChoice>(
+                    getBandSlotID(band, slot),
+                    bandName + " Slot " + String(slot) + " Algorithm",
+                    featureSlotAlgorithmOptions,
+                    0
+            ));
+        }
+    }
+
+    // Automatables
+    for (int i = 1; i <= NUMBER_OF_AUTOMATABLES; i++){
+        layout.add(make_unique<AudioParameterFloat>(
+                "auto" + String(i),
+                "Automatable " + String(i),
+                0.0f,
+                1.0f,
+                0.0f
+        ));
+    }
+
+    return layout;
 }
 
 void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                                               juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    // The benchmark and offline executables assert on any heap allocation inside processBlock (see AllocationTracker)
+    ScopedRealtimeAllocationCheck allocationCheck;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
     auto numSamples = buffer.getNumSamples();
@@ -169,18 +154,6 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
         return;
     }
 
-    // Don't calculate if block size is not a factor of 2
-    if(numSamples > 0 && numSamples % 2 != 0){
-        return;
-    }
-
-    // Apples AU validation system currently doesn't accept buffer sizes >= 4096 and sampling rates greater than 96000
-    // The issue likely lies in the memory management of the current implementation
-    // TODO: Find and fix the error in a future version
-    if(numSamples >= 4096 || getSampleRate() > 96000){
-        return;
-    }
-
     // In case we have more outputs than inputs, this code clears any output
     // channels that didn't contain input data, (because these aren't
     // guaranteed to be empty - they may contain garbage).
@@ -190,142 +163,79 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // Clear essentia audiobuffer
-    eGlobalAudioBuffer.clear();
-
-    auto* reader = buffer.getReadPointer(0);
-    for (int i = 0; i < buffer.getNumSamples(); i++){
-        eGlobalAudioBuffer.push_back(reader[i]);
-    }
-
-    // Essentia algorithms compute routines
-    aWindowing->compute();
-    aSpectrum->compute();
-    aSpectralCentroid->compute();
-    aPitchYIN->compute();
-    aLoudness->compute();
-    aOnsetDetection->compute();
-    aSpectralPeaks->compute();
-    aDissonance->compute();
-    // aMelBands->compute();
-    // aHPCP->compute();
-
-    // Chord detection (currently not in use)
-    /*
-    eChordDetectionInput.emplace_back(eHPCP);
-    if(eChordDetectionInput.size() > 2){
-        aChordsDetection->compute();
-
-        int strongestChordIdx = std::distance(eChordsStrengths.begin(), std::max_element(eChordsStrengths.begin(), eChordsStrengths.end()));
-        eStrongestChord = eChords[strongestChordIdx];
-
-        eChords.clear();
-        eChordsStrengths.clear();
-        eChordDetectionInput.clear();
-    }
-
-    // Hack: Trim spectrum, libmapper supports a maximum of 128 numbers to be submitted simultaneously in an array
-    vector<Real>::const_iterator first = eSpectrumData.begin();
-    vector<Real>::const_iterator last = eSpectrumData.begin() + 128;
-    vector<Real> specData(first, last);
-    */
-
-    // Additional multiband processing (if more than 1 band is selected)
-    if(*paramNumberOfBands > 0.0f){
-        lowBuffer->clear();
-        midBuffer->clear();
-        highBuffer->clear();
-
-        auto numSamples = buffer.getNumSamples();
-
-        // Loop over channels and perform filtering
-        for (int channel = 0; channel < totalNumOutputChannels; ++channel)
-        {
-            // Copy samples to buffers
-            lowBuffer->copyFrom(channel, 0, buffer, channel, 0, numSamples);
-            midBuffer->copyFrom(channel, 0, buffer, channel, 0, numSamples);
-            highBuffer->copyFrom(channel, 0, buffer, channel, 0, numSamples);
-
-            // Perform filtering
-            auto* lowWriter = lowBuffer->getWritePointer(channel);
-            auto* highWriter = highBuffer->getWritePointer(channel);
-            for (int sample = 0; sample < numSamples; sample++){
-                lowWriter[sample] = lowpassFilters[channel].processSample(lowWriter[sample]);
-                highWriter[sample] = highpassFilters[channel].processSample(highWriter[sample]);
+    // Timestamp the block, so every analysis frame can be related to the audio it was computed from
+    // If the host doesn't provide a position, the samples are counted from the start of playback instead
+    const auto timeMs = Time::getMillisecondCounterHiRes();
+    auto hostSamplePosition = nextHostSamplePosition;
+    if(auto* playHead = getPlayHead()){
+        if(auto position = playHead->getPosition()){
+            if(auto timeInSamples = position->getTimeInSamples()){
+                hostSamplePosition = *timeInSamples;
             }
-
-            // Calculate mid band by subtracting low and high band from input signal
-            midBuffer->addFrom(channel, 0, lowBuffer->getReadPointer(channel), numSamples, -1.0f);
-            midBuffer->addFrom(channel, 0, highBuffer->getReadPointer(channel), numSamples, -1.0f);
         }
+    }
+    nextHostSamplePosition = hostSamplePosition + numSamples;
+
+    // Blocks of any length are accepted: the analysis worker reframes them into fixed-size frames.
+    // Hosts may pass blocks larger than announced in prepareToPlay (e.g. during offline rendering),
+    // so the block is processed in chunks that fit the preallocated sub-band buffers
+    // Before prepareToPlay() sized the buffers there is nothing to process into (the sample rate may already be set)
+    const auto maximumBlockSize = bandBuffer.getNumSamples();
+    if(maximumBlockSize <= 0){
+        return;
+    }
+    for (int startSample = 0; startSample < numSamples; startSample += maximumBlockSize){
+        AudioBuffer<float> subBlock(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), startSample, jmin(maximumBlockSize, numSamples - startSample));
+        processSubBlock(subBlock, hostSamplePosition + startSample, timeMs + 1000.0 * startSample / getSampleRate());
+    }
+}
 
-        // Send to sub-bands and process
-        // Clear essentia sub band buffers
-        eLowAudioBuffer.clear();
-        eMidAudioBuffer.clear();
-        eHighAudioBuffer.clear();
-
-        auto* lowReader = lowBuffer->getReadPointer(0);
-        auto* midReader = midBuffer->getReadPointer(0);
-        auto* highReader = highBuffer->getReadPointer(0);
+void AudioPluginAudioProcessor::processSubBlock(AudioBuffer<float>& buffer, int64 hostSamplePosition, double timeMs) {
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    auto numSamples = buffer.getNumSamples();
 
-        for (int i = 0; i < buffer.getNumSamples(); i++){
-            eLowAudioBuffer.emplace_back(lowReader[i]);
-            eMidAudioBuffer.emplace_back(midReader[i]);
-            eHighAudioBuffer.emplace_back(highReader[i]);
-        }
+    // Hand samples over to the analysis thread before the main buffer is overwritten
+    // All Essentia algorithms, the band splitting and the FeatureSlots are computed there, so this is only a copy
+    // (which also derives the selected analysis source from the left and right channel)
+    // Mono inputs use the same channel for left and right
+    const auto rightChannel = buffer.getNumChannels() > 1 ? 1 : 0;
+    const auto source = static_cast<AnalysisWorker::Source>(roundToInt(paramAnalysisSource->load()));
+    analysisWorker->pushSamples(buffer.getReadPointer(0), buffer.getReadPointer(rightChannel), numSamples, source, hostSamplePosition, timeMs);
+
+    // The host audio passes through untouched unless soloed bands are monitored
+    // Only then are the bands split (and reconstructed) on the audio thread
+    // Crossover changes from the message thread take effect at the start of a block
+    crossover.applyPendingChanges();
+    const auto numBands = crossover.getNumBands();
+    if(*paramBandMonitoring == 0.0f || numBands == 1 || noSolo(numBands)){
+        bandMonitoringActive = false;
+        return;
+    }
 
-        // 2 bands (low and high) => ignore mid band
-        for(auto& featureSlot : lowBandSlots){
-            featureSlot->compute();
-        }
-        for(auto& featureSlot : highBandSlots){
-            featureSlot->compute();
-        }
-        // Also process mid-band if three bands are selected
-        if(*paramNumberOfBands == 2.0f){
-            for(auto& featureSlot : midBandSlots){
-                featureSlot->compute();
-            }
-        }
+    // The filter states are stale if monitoring was paused
+    if(!bandMonitoringActive){
+        crossover.reset();
+        bandMonitoringActive = true;
+    }
 
-        // Clear main buffer
-        buffer.clear();
+    // Split into bands (phase-coherent, the bands sum to an allpass response)
+    crossover.process(buffer, bandBuffer, numSamples);
 
-        // Playback
-        // If no channel is soloed, play all streams back
-        if (noSolo()) {
-            for (int channel = 0; channel < totalNumOutputChannels; channel++) {
-                buffer.addFrom(channel, 0, *lowBuffer, channel, 0, numSamples);
-                buffer.addFrom(channel, 0, *midBuffer, channel, 0, numSamples);
-                buffer.addFrom(channel, 0, *highBuffer, channel, 0, numSamples);
+    // Play back only the soloed bands
+    buffer.clear();
+    const auto numChannels = jmin(totalNumOutputChannels, buffer.getNumChannels(), 2);
+    for (int band = 0; band < numBands; band++) {
+        if(*paramBandSolos[band] > 0.0f){
+            for (int channel = 0; channel < numChannels; channel++) {
+                buffer.addFrom(channel, 0, bandBuffer, getBandChannel(band, channel), 0, numSamples);
             }
         }
-        // Otherwise play only from soloed bands
-        else {
-            for (int channel = 0; channel < totalNumOutputChannels; channel++) {
-                if(*paramLowSolo > 0.0f){
-                    buffer.addFrom(channel, 0, *lowBuffer, channel, 0, numSamples);
-                }
-                if(*paramMidSolo > 0.0f){
-                    buffer.addFrom(channel, 0, *midBuffer, channel, 0, numSamples);
-                }
-                if(*paramHighSolo > 0.0f){
-                    buffer.addFrom(channel, 0, *highBuffer, channel, 0, numSamples);
-                }
-            }
-        }
-
     }
 }
 
 //==============================================================================
 void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    if(samplesPerBlock >= 4096 || sampleRate > 96000){
-        return;
-    }
-
     // Reinitialise essentia if it is not initialised
     if(!essentia::isInitialized()){
         essentia::init();
@@ -334,93 +244,73 @@ void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
     // Store sample rate in state management
     magicState.getPropertyAsValue("sampleRate").setValue(sampleRate);
 
-    // Create algorithms
-    standard::AlgorithmFactory& factory = standard::AlgorithmFactory::instance();
-
-    aWindowing.reset(factory.create("Windowing", "type", "blackmanharris62"));
-    aSpectrum.reset(factory.create("Spectrum"));
-    aMFCC.reset(factory.create("MFCC"));
-    aSpectralCentroid.reset(factory.create("SpectralCentroidTime", "sampleRate", sampleRate));
-    aPitchYIN.reset(factory.create("PitchYin", "sampleRate", sampleRate, "frameSize", samplesPerBlock));
-    aLoudness.reset(factory.create("Loudness"));
-    aOnsetDetection.reset(factory.create("OnsetDetection", "method", "hfc", "sampleRate", sampleRate));
-    aSpectralPeaks.reset(factory.create("SpectralPeaks", "sampleRate", sampleRate));
-    aDissonance.reset(factory.create("Dissonance"));
-
-    // Currently unused algorithms
-    // aMelBands.reset(factory.create("MelBands", "inputSize", static_cast<int>(samplesPerBlock / 2 + 1), "sampleRate", sampleRate, "numberBands", 128));
-    // aHPCP.reset(factory.create("HPCP", "sampleRate", sampleRate, "nonLinear", true));
-    // aChordsDetection.reset(factory.create("ChordsDetection", "sampleRate", sampleRate, "windowSize", 1));
-
-    // Connect algorithms
-    aWindowing->input("frame").set(eGlobalAudioBuffer);
-    aWindowing->output("frame").set(windowedFrame);
-    aSpectrum->input("frame").set(windowedFrame);
-    aSpectrum->output("spectrum").set(eSpectrumData);
-
-    // aMelBands->input("spectrum").set(eSpectrumData);
-    // aMelBands->output("bands").set(eMelBands);
-
-    // Pitch detection
-    aPitchYIN->input("signal").set(eGlobalAudioBuffer);
-    aPitchYIN->output("pitch").set(ePitchYIN);
-    aPitchYIN->output("pitchConfidence").set(ePitchConfidence);
-
-    // Spectral centroid
-    aSpectralCentroid->input("array").set(eGlobalAudioBuffer);
-    aSpectralCentroid->output("centroid").set(eSpectralCentroid);
-
-    // Loudness
-    aLoudness->input("signal").set(eGlobalAudioBuffer);
-    aLoudness->output("loudness").set(eLoudness);
-
-    // Onset detection
-    // Dummy phase vector necessary as essentia algorithms must be initialised with all fields set to something
-    // Phase would only be used in the complex ODF, so we can use an empty vector here
-    vector<Real> dummyPhase;
-    aOnsetDetection->input("spectrum").set(eSpectrumData);
-    aOnsetDetection->input("phase").set(dummyPhase);
-    aOnsetDetection->output("onsetDetection").set(eOnsetDetection);
-
-    // Spectral peaks
-    aSpectralPeaks->input("spectrum").set(eSpectrumData);
-    aSpectralPeaks->output("frequencies").set(eSpectralPeaksFrequencies);
-    aSpectralPeaks->output("magnitudes").set(eSpectralPeaksMagnitudes);
-
-    aDissonance->input("frequencies").set(eSpectralPeaksFrequencies);
-    aDissonance->input("magnitudes").set(eSpectralPeaksMagnitudes);
-    aDissonance->output("dissonance").set(eDissonance);
-
-    // Currently unused
-    // Harmonic Pitch Class Profile
-    // aHPCP->input("frequencies").set(eSpectralPeaksFrequencies);
-    // aHPCP->input("magnitudes").set(eSpectralPeaksMagnitudes);
-    // aHPCP->output("hpcp").set(eHPCP);
-
-    // Chord detection
-    // aChordsDetection->input("pcp").set(eChordDetectionInput);
-    // aChordsDetection->output("chords").set(eChords);
-    // aChordsDetection->output("strength").set(eChordsStrengths);
-    // End Currently unused
-
-    // Setup sub-band buffers
-    lowBuffer = make_unique<AudioBuffer<float>>(2, samplesPerBlock);
-    midBuffer = make_unique<AudioBuffer<float>>(2, samplesPerBlock);
-    highBuffer = make_unique<AudioBuffer<float>>(2, samplesPerBlock);
-
-    if(sampleRate > 0 && samplesPerBlock > 0){
-        // Reset/start timers for libmapper communication and GUI updates
-        stopTimer(0);
-        stopTimer(1);
-        // Libmapper timer
-        startTimer(0, 10);
-        // GUI timer
-        startTimer(1, static_cast<int>((samplesPerBlock / sampleRate) * 1000));
-    }
-}
-
-bool AudioPluginAudioProcessor::noSolo() {
-    return *paramLowSolo == 0.0f && *paramMidSolo == 0.0f && *paramHighSolo == 0.0f;
+    // Recreate the analysis chain for the new configuration
+    // The worker must be stopped while its algorithms and buffers are replaced
+    analysisWorker->stopThread(ANALYSIS_THREAD_STOP_TIMEOUT_MS);
+    analysisWorker->prepare(sampleRate, samplesPerBlock, ANALYSIS_FRAME_SIZE, ANALYSIS_HOP_SIZE);
+    nextHostSamplePosition = 0;
+    analysisWorker->startThread();
+
+    // Sample rate after decimation, used by the FeatureSlot algorithms
+    magicState.getPropertyAsValue("analysisSampleRate").setValue(analysisWorker->getAnalysisSampleRate());
+    // Rebuild the FeatureSlot algorithms for the new analysis sample rate (asynchronously, on the message thread)
+    for (auto& slots : bandSlots){
+        for (auto& featureSlot : slots){
+            featureSlot->reinitialise();
+        }
+    }
+
+    // Setup sub-band buffer, 2 channels per band
+    bandBuffer.setSize(2 * MAX_NUMBER_OF_BANDS, samplesPerBlock);
+
+    // Setup crossover for the new sample rate
+    crossover.prepare(sampleRate, samplesPerBlock, 2);
+    updateCrossover();
+}
+
+AnalysisWorker& AudioPluginAudioProcessor::prepareForOfflineAnalysis(double sampleRate, int blockSize) {
+    prepareToPlay(sampleRate, blockSize);
+
+    // The caller drives the analysis, nothing is published over the network
+    analysisWorker->stopThread(ANALYSIS_THREAD_STOP_TIMEOUT_MS);
+    if(libmapperPublisher != nullptr){
+        libmapperPublisher->stopThread(LIBMAPPER_THREAD_STOP_TIMEOUT_MS);
+    }
+
+    // Don't wait for the message loop to rebuild the slots for the new sample rate and the selected algorithms
+    for (auto& slots : bandSlots){
+        for (auto& featureSlot : slots){
+            featureSlot->applyPendingChanges();
+        }
+    }
+
+    return *analysisWorker;
+}
+
+bool AudioPluginAudioProcessor::noSolo(int numBands) {
+    for (int band = 0; band < numBands; band++){
+        if(*paramBandSolos[band] > 0.0f){
+            return false;
+        }
+    }
+    return true;
+}
+
+int AudioPluginAudioProcessor::getBandChannel(int band, int channel) {
+    return 2 * band + channel;
+}
+
+int AudioPluginAudioProcessor::getNumberOfBands() const {
+    // The parameter holds the index of the choice, "1" to "MAX_NUMBER_OF_BANDS"
+    return jlimit(1, MAX_NUMBER_OF_BANDS, roundToInt(paramNumberOfBands->load()) + 1);
+}
+
+void AudioPluginAudioProcessor::updateBandsEnabled() {
+    const auto numBands = getNumberOfBands();
+    magicState.getPropertyAsValue(MULTIBAND_ENABLED_ID.toString()) = numBands > 1;
+    for (int band = 0; band < MAX_NUMBER_OF_BANDS; band++){
+        magicState.getPropertyAsValue(getBandEnabledID(band)) = band < numBands;
+    }
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
@@ -429,20 +319,23 @@ AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
     magicState.getValueTreeState().removeParameterListener("numberOfBands", this);
     magicState.getValueTreeState().removeParameterListener("lowpassCutoff", this);
     magicState.getValueTreeState().removeParameterListener("highpassCutoff", this);
-    magicState.getValueTreeState().removeParameterListener("lowSolo", this);
-    magicState.getValueTreeState().removeParameterListener("midSolo", this);
-    magicState.getValueTreeState().removeParameterListener("highSolo", this);
 
-    for (int i = 0; i < NUMBER_OF_AUTOMATABLES; i++){
-        string name = "auto";
-        name.append(to_string(i + 1));
-        magicState.getValueTreeState().removeParameterListener(name, this);
+    // Stop publishing before the signals and the values it reads are torn down
+    if(libmapperPublisher != nullptr){
+        libmapperPublisher->stopThread(LIBMAPPER_THREAD_STOP_TIMEOUT_MS);
     }
 
     autoParams.clear();
 
-    // Shutdown essentia
-    essentia::shutdown();
+    // Stop analysis before the FeatureSlots and Essentia are torn down
+    analysisWorker->getFrameNotifier().removeListener(this);
+    cancelPendingUpdate();
+    analysisWorker->stopThread(ANALYSIS_THREAD_STOP_TIMEOUT_MS);
+
+    // Shutdown essentia once no other processor (e.g. another plugin instance or offline job) uses it anymore
+    if(--numEssentiaUsers == 0){
+        essentia::shutdown();
+    }
 }
 
 //==============================================================================
@@ -512,6 +405,8 @@ void AudioPluginAudioProcessor::changeProgramName (int index, const juce::String
 
 void AudioPluginAudioProcessor::releaseResources()
 {
+    // No need to analyse anything while the host isn't playing through the plugin
+    analysisWorker->stopThread(ANALYSIS_THREAD_STOP_TIMEOUT_MS);
 }
 
 bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -565,74 +460,104 @@ void AudioPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData
 void AudioPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
     // Load plugin state from disk
-    magicState.setStateInformation (data, sizeInBytes, getActiveEditor());
-
-    // Set filter cutoff frequencies
-    paramLowpassCutoff = paramLowpassCutoff.getValue();
-    paramHighpassCutoff = paramHighpassCutoff.getValue();
-    for (int i = 0; i < lowpassFilters.size(); i++) {
-        lowpassFilters[i].coefficients = dsp::IIR::Coefficients<float>::makeLowPass(getSampleRate(), paramLowpassCutoff.getValue(), SQRT_2_OVER_2);
-        highpassFilters[i].coefficients = dsp::IIR::Coefficients<float>::makeHighPass(getSampleRate(), paramHighpassCutoff.getValue(), SQRT_2_OVER_2);
+    // Sessions saved before the bands were numbered store the slot and solo settings under the low/mid/high IDs
+    auto state = ValueTree::readFromData(data, static_cast<size_t>(sizeInBytes));
+    if(state.isValid() && migrateLegacyParameterIDs(state)){
+        MemoryOutputStream stream;
+        state.writeToStream(stream);
+        magicState.setStateInformation (stream.getData(), static_cast<int>(stream.getDataSize()), getActiveEditor());
+    } else {
+        magicState.setStateInformation (data, sizeInBytes, getActiveEditor());
     }
 
-    // Show / hide mid band
-    magicState.getPropertyAsValue(MIDBAND_ENABLED_ID.toString()).setValue(*paramNumberOfBands == 2.0f);
+    // Set filter cutoff frequencies and enable / disable bands, even if the loaded parameters didn't change
+    numberOfBandsChanged = true;
+    if(mode == REALTIME){
+        triggerAsyncUpdate();
+    }
 }
 
-vector <Real> &AudioPluginAudioProcessor::getSpectrumData() {
-    return eSpectrumData;
+bool AudioPluginAudioProcessor::migrateLegacyParameterIDs(ValueTree& state) {
+    // The value tree state stores every parameter as a PARAM child with its identifier in the "id" property
+    auto migrated = false;
+    for (auto child : state){
+        if(child.hasType("PARAM")){
+            const auto newID = getMigratedBandParameterID(child.getProperty("id").toString());
+            if(newID.isNotEmpty()){
+                child.setProperty("id", newID, nullptr);
+                migrated = true;
+            }
+        }
+    }
+    return migrated;
 }
 
-Real &AudioPluginAudioProcessor::getSpectralCentroid() {
-    return eSpectralCentroid;
+void AudioPluginAudioProcessor::readFeatureFrame(FeatureFrame& frame) const {
+    analysisWorker->readFeatureFrame(frame);
 }
 
 void AudioPluginAudioProcessor::parameterChanged(const String &parameterID, float newValue) {
+    ignoreUnused(newValue);
+    // The crossover coefficients are allocated and it must have a single writer, so it is only updated on the
+    // message thread. The new values are read from the parameters there.
     if(parameterID == "lowpassCutoff"){
-        paramLowpassCutoff = newValue;
-        // Set filter cutoff frequencies
-        for (auto & lowpassFilter : lowpassFilters) {
-            lowpassFilter.coefficients = dsp::IIR::Coefficients<float>::makeLowPass(getSampleRate(), newValue, SQRT_2_OVER_2);
-        }
+        lowpassCutoffChanged = true;
+    } else if(parameterID == "highpassCutoff"){
+        highpassCutoffChanged = true;
+    } else if(parameterID == "numberOfBands"){
+        numberOfBandsChanged = true;
+    } else {
+        return;
+    }
+    // Offline there is no message loop, prepareForOfflineAnalysis() updates the crossover instead
+    if(mode == REALTIME){
+        triggerAsyncUpdate();
+    }
+}
 
-        // Also update highpassCutoff if 2 bands are selected
-        if(*paramNumberOfBands == 1.0f){
-            magicState.getValueTreeState().getParameterAsValue("highpassCutoff").setValue(newValue);
-            for (auto & filter : highpassFilters) {
-                filter.coefficients = dsp::IIR::Coefficients<float>::makeHighPass(getSampleRate(), newValue, SQRT_2_OVER_2);
-            }
-        }
+void AudioPluginAudioProcessor::applyCrossoverParameterChanges() {
+    const auto lowpassChanged = lowpassCutoffChanged.exchange(false);
+    const auto highpassChanged = highpassCutoffChanged.exchange(false);
+    const auto bandsChanged = numberOfBandsChanged.exchange(false);
+    if(!lowpassChanged && !highpassChanged && !bandsChanged){
+        return;
     }
-    if(parameterID == "highpassCutoff"){
-        paramHighpassCutoff = newValue;
-        // Set filter cutoff frequencies
-        for (auto & highpassFilter : highpassFilters) {
-            highpassFilter.coefficients = dsp::IIR::Coefficients<float>::makeHighPass(getSampleRate(), newValue, SQRT_2_OVER_2);
-        }
 
-        // Also update lowpassCutoff if 2 bands are selected
-        if(*paramNumberOfBands == 1.0f){
-            magicState.getValueTreeState().getParameterAsValue("lowpassCutoff").setValue(newValue);
-            for (auto & filter : lowpassFilters) {
-                filter.coefficients = dsp::IIR::Coefficients<float>::makeLowPass(getSampleRate(), newValue, SQRT_2_OVER_2);
-            }
-        }
+    if(bandsChanged){
+        updateBandsEnabled();
     }
-    if(parameterID == "numberOfBands"){
-        magicState.getPropertyAsValue(MULTIBAND_ENABLED_ID.toString()) = newValue >= 1.0f;
-        magicState.getPropertyAsValue(MIDBAND_ENABLED_ID.toString()) = newValue == 2.0f;
 
-        // If 2 bands are selected snap highpass cutoff value to lowpass cutoff value
-        if(newValue == 1.0f){
-            magicState.getValueTreeState().getParameterAsValue("highpassCutoff").setValue(paramLowpassCutoff.getValue());
-            for (auto & filter : highpassFilters) {
-                filter.coefficients = dsp::IIR::Coefficients<float>::makeHighPass(getSampleRate(), paramLowpassCutoff.getValue(), SQRT_2_OVER_2);
-            }
+    // With 2 bands both cutoffs are the same crossover: a new band count or lowpass cutoff snaps the highpass cutoff
+    // to the lowpass cutoff, a new highpass cutoff is copied to the lowpass cutoff
+    if(getNumberOfBands() == 2){
+        if(lowpassChanged || bandsChanged){
+            magicState.getValueTreeState().getParameterAsValue("highpassCutoff").setValue(paramLowpassCutoff->load());
+        } else {
+            magicState.getValueTreeState().getParameterAsValue("lowpassCutoff").setValue(paramHighpassCutoff->load());
         }
     }
-    if(parameterID.contains("auto")){
-        int idx = parameterID.toStdString().back() - '0' - 1;
-        sensorsAutomatables[idx]->update(newValue);
+
+    // Set filter cutoff frequencies
+    updateCrossover();
+}
+
+void AudioPluginAudioProcessor::updateCrossover() {
+    const auto sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+    const auto numCrossovers = getNumberOfBands() - 1;
+    const auto lowCutoff = paramLowpassCutoff->load();
+    // In 2-band mode the highpass cutoff follows the lowpass cutoff
+    const auto highCutoff = numCrossovers > 1 ? jmax(lowCutoff, paramHighpassCutoff->load()) : lowCutoff;
+
+    // The lowest crossover is at the lowpass cutoff, the highest at the highpass cutoff and those in between are
+    // evenly spaced on a logarithmic scale
+    array<float, MAX_NUMBER_OF_BANDS - 1> frequencies {};
+    LinkwitzRileyCrossover::getLogSpacedFrequencies(lowCutoff, highCutoff, numCrossovers, frequencies.data());
+    crossover.setCrossoverFrequencies(frequencies.data(), numCrossovers);
+    analysisWorker->setCrossoverFrequencies(frequencies.data(), numCrossovers);
+
+    for (int i = 0; i < lowpassFilters.size(); i++) {
+        lowpassFilters[i].coefficients = dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, lowCutoff, SQRT_2_OVER_2);
+        highpassFilters[i].coefficients = dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, highCutoff, SQRT_2_OVER_2);
     }
 }
 
@@ -644,36 +569,84 @@ array<dsp::IIR::Filter<float>, 2> &AudioPluginAudioProcessor::getHighpassFilters
     return highpassFilters;
 }
 
-void AudioPluginAudioProcessor::timerCallback(int timerID) {
-    // Libmapper update timer
-    if(timerID == 0){
-        // Poll libmapper device
-        libmapperDevice->poll();
+void AudioPluginAudioProcessor::analysisFrameReady() {
+    // Coalesce to GUI_MAX_UPDATE_RATE_HZ, pending updates are merged by the AsyncUpdater anyway
+    const auto now = Time::getMillisecondCounterHiRes();
+    if(now >= nextGUIUpdate){
+        nextGUIUpdate = now + 1000.0 / GUI_MAX_UPDATE_RATE_HZ;
+        triggerAsyncUpdate();
+    }
+}
+
+void AudioPluginAudioProcessor::handleAsyncUpdate() {
+    applyCrossoverParameterChanges();
+
+    analysisWorker->readFeatureFrame(guiFrame);
+
+    // Display current feature extraction values in GUI
+    magicState.getPropertyAsValue(SPECTRAL_CENTROID_ID.toString()).setValue(roundToInt(guiFrame.spectralCentroid));
+    // Only display pitch if confidence is greater than chance
+    auto pitchValue = guiFrame.pitchConfidence > 0.5 ? guiFrame.pitchYIN : -1;
+    magicState.getPropertyAsValue(PITCH_YIN_ID.toString()).setValue(roundToInt(pitchValue));
+    magicState.getPropertyAsValue(LOUDNESS_ID.toString()).setValue(roundToInt(guiFrame.loudness));
+    magicState.getPropertyAsValue(ODF_ID.toString()).setValue(guiFrame.onsetDetection);
+    magicState.getPropertyAsValue(DISSONANCE_ID.toString()).setValue(guiFrame.dissonance);
+
+    // FeatureSlot values come with the same frame, so idle slots cost nothing
+    for (int band = 0; band < getNumberOfBands(); band++){
+        for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++){
+            const auto index = FeatureFrame::getSlotIndex(band, slot);
+            if(guiFrame.slotActive[index]){
+                bandSlots[band][slot]->displayValue(guiFrame.slotValues[index]);
+            }
+        }
+    }
+
+    const auto now = Time::getMillisecondCounterHiRes();
+    if(now >= nextDiagnosticsUpdate){
+        nextDiagnosticsUpdate = now + 1000.0 / DIAGNOSTICS_UPDATE_RATE_HZ;
+        updateDiagnostics();
+    }
+
+    //    var strongestChord = var(eStrongestChord);
+    //    magicState.getPropertyAsValue(STRONGEST_CHORD_ID.toString()).setValue(strongestChord);
+}
 
-        // Send data to libmapper
-        sensorSpectralCentroid->update(eSpectralCentroid);
-        sensorPitchYIN->update(ePitchYIN);
-        sensorLoudness->update(eLoudness);
-        sensorOnsetDetection->update(eOnsetDetection);
-        sensorDissonance->update(eDissonance);
+void AudioPluginAudioProcessor::updateDiagnostics() {
+    const auto& profiler = analysisWorker->getProfiler();
+    auto format = [](const TimingHistogram::Summary& summary){
+        return String(summary.p50, 1) + " / " + String(summary.p99, 1) + " / " + String(summary.max, 1) + " us";
+    };
 
-        // sensorSpectrum->update(specData);
-        // sensorMelBands->update(eMelBands);
+    for (int stage = 0; stage < AnalysisProfiler::NUMBER_OF_STAGES; stage++){
+        const auto id = static_cast<AnalysisProfiler::Stage>(stage);
+        magicState.getPropertyAsValue(AnalysisProfiler::getStagePropertyID(id)).setValue(format(profiler.getStage(id).getSummary()));
     }
-    // GUI update timer
-    else if(timerID == 1){
-        // Display current feature extraction values in GUI
-        magicState.getPropertyAsValue(SPECTRAL_CENTROID_ID.toString()).setValue(roundToInt(eSpectralCentroid));
-        // Only display pitch if confidence is greater than chance
-        auto pitchValue = ePitchConfidence > 0.5 ? ePitchYIN : -1;
-        magicState.getPropertyAsValue(PITCH_YIN_ID.toString()).setValue(roundToInt(pitchValue));
-        magicState.getPropertyAsValue(LOUDNESS_ID.toString()).setValue(roundToInt(eLoudness));
-        magicState.getPropertyAsValue(ODF_ID.toString()).setValue(eOnsetDetection);
-        magicState.getPropertyAsValue(DISSONANCE_ID.toString()).setValue(eDissonance);
 
-        //    var strongestChord = var(eStrongestChord);
-        //    magicState.getPropertyAsValue(STRONGEST_CHORD_ID.toString()).setValue(strongestChord);
+    // Only the most expensive FeatureSlot in use is displayed
+    String slowestSlot = "-";
+    float slowestP99 = -1.0f;
+    for (int band = 0; band < getNumberOfBands(); band++){
+        for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++){
+            const auto summary = profiler.getSlot(band, slot).getSummary();
+            if(guiFrame.slotActive[FeatureFrame::getSlotIndex(band, slot)] && summary.p99 > slowestP99){
+                slowestP99 = summary.p99;
+                slowestSlot = "Band " + String(band + 1) + " Slot " + String(slot + 1) + ": " + format(summary);
+            }
+        }
+    }
+    magicState.getPropertyAsValue(SLOWEST_SLOT_TIMING_ID.toString()).setValue(slowestSlot);
+
+    // Features the governor currently computes less often than scheduled
+    String loadShedding = String(roundToInt(100.0f * guiFrame.analysisLoad)) + " % load";
+    for (int feature = 0; guiFrame.sheddingLevel > 0 && feature < AnalysisScheduler::NUMBER_OF_FEATURES; feature++){
+        const auto id = static_cast<AnalysisScheduler::Feature>(feature);
+        if(AnalysisScheduler::isSheddable(id)){
+            loadShedding << ", " << AnalysisScheduler::getFeatureName(id) << " at "
+                         << String(guiFrame.featureRates[feature], 1) << " Hz";
+        }
     }
+    magicState.getPropertyAsValue(LOAD_SHEDDING_ID.toString()).setValue(loadShedding);
 }
 
 void AudioPluginAudioProcessor::updateTrackProperties(const AudioProcessor::TrackProperties &properties) {
@@ -689,39 +662,169 @@ void AudioPluginAudioProcessor::updateTrackProperties(const AudioProcessor::Trac
 }
 
 void AudioPluginAudioProcessor::libmapperSetup(const string& deviceName) {
+    // Stop publishing before the device and its signals are replaced
+    libmapperPublisher.reset();
+
     libmapperDevice = make_unique<mapper::Device>(deviceName);
     sensorSpectralCentroid = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("spectralCentroid", 1, 'f', nullptr, nullptr, nullptr));
-    sensorSpectrum = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("spectrum", 128, 'f', 0, 0, 0));
     sensorPitchYIN = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("pitchYIN", 1, 'f', 0, 0, 0));
     sensorLoudness = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("loudness", 1, 'f', 0, 0, 0));
     sensorOnsetDetection = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("onsetDetection", 1, 'f', 0, 0, 0));
     sensorDissonance = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("dissonance", 1, 'f', 0, 0, 0));
-//    sensorMelBands = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("melBands", 128, 'f', 0, 0, 0));
+    sensorAnalysisLatency = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("analysisLatency", 1, 'f', 0, 0, 0));
+    sensorMelBands = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("melBands", NUMBER_OF_MEL_BANDS, 'f', 0, 0, 0));
+    sensorAnalysisLoad = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("analysisLoad", 1, 'f', 0, 0, 0));
+    sensorFeatureRates = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("featureRates", AnalysisScheduler::NUMBER_OF_FEATURES, 'f', "Hz", 0, 0));
+    sensorStageTimings = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("debugStageTimings", 3 * AnalysisProfiler::NUMBER_OF_STAGES, 'f', "us", 0, 0));
+    sensorSlotTimings = make_unique<mapper::Signal>(libmapperDevice->add_output_signal("debugSlotTimings", 3 * MAX_NUMBER_OF_BANDS * NUMBER_OF_SLOTS, 'f', "us", 0, 0));
+
+    // The spectrum is longer than a single libmapper vector, hence it is split into consecutive chunks
+    sensorsSpectrum.clear();
+    for (int i = 0; i < SPECTRUM_PUBLISH_BINS / LIBMAPPER_MAX_VECTOR_LENGTH; i++){
+        string name = "spectrum_";
+        name.append(to_string(i + 1));
+        sensorsSpectrum.emplace_back(make_unique<mapper::Signal>(libmapperDevice->add_output_signal(name, LIBMAPPER_MAX_VECTOR_LENGTH, 'f', 0, 0, 0)));
+        sensorsSpectrum.back()->set_rate(SPECTRUM_PUBLISH_RATE_HZ);
+    }
 
     sensorSpectralCentroid->set_rate(30);
-    sensorSpectrum->set_rate(30);
+    sensorMelBands->set_rate(SPECTRUM_PUBLISH_RATE_HZ);
     sensorPitchYIN->set_rate(30);
     sensorLoudness->set_rate(30);
     sensorOnsetDetection->set_rate(30);
     sensorDissonance->set_rate(30);
 
-    // Clear slots before setting up libmapper
-    lowBandSlots.clear();
-    midBandSlots.clear();
-    highBandSlots.clear();
-
-    for (int i = 0; i < NUMBER_OF_SLOTS; i++){
-        lowBandSlots.emplace_back(make_unique<FeatureSlotProcessor>(*libmapperDevice, magicState, FeatureSlotProcessor::LOW, eLowAudioBuffer, i + 1));
-        midBandSlots.emplace_back(make_unique<FeatureSlotProcessor>(*libmapperDevice, magicState, FeatureSlotProcessor::MID, eMidAudioBuffer, i + 1));
-        highBandSlots.emplace_back(make_unique<FeatureSlotProcessor>(*libmapperDevice, magicState, FeatureSlotProcessor::HIGH, eHighAudioBuffer, i + 1));
-    }
+    // The FeatureSlots' signals belong to the device, so they are recreated with it
+    createFeatureSlots(libmapperDevice.get());
 
     // Setup automatables in libmapper
+    sensorsAutomatables.clear();
     for (int i = 0; i < NUMBER_OF_AUTOMATABLES; i++){
         string name = "Automatable_";
         name.append(to_string(i + 1));
         sensorsAutomatables.emplace_back(make_unique<mapper::Signal>(libmapperDevice->add_output_signal(name, 1, 'f', 0, 0, 0)));
     }
+
+    // All signals are updated in one batch by the publisher thread, which is also the only one polling the device
+    libmapperPublisher = make_unique<LibmapperPublisher>(*libmapperDevice, analysisWorker->getFrameNotifier());
+    auto* worker = analysisWorker.get();
+    // Every batch reads one consistent snapshot of the analysis results and is timetagged with the time of the audio
+    // its frame was computed from instead of the time it is sent
+    libmapperPublisher->setBatchReader([this, worker](double& timeMs){
+        worker->readFeatureFrame(libmapperFrame);
+        timeMs = libmapperFrame.timeMs;
+        return libmapperFrame.frameNumber > 0;
+    });
+    // The latency (in seconds) only changes with the sample rate, so it is only sent when it changes
+    libmapperPublisher->addVectorSignal(*sensorAnalysisLatency, 1, [this, worker, lastLatency = -1.0f](float* values) mutable {
+        const auto latency = static_cast<float>(worker->getLatencySamples() / getSampleRate());
+        if(latency == lastLatency){
+            return false;
+        }
+        lastLatency = latency;
+        *values = latency;
+        return true;
+    });
+    libmapperPublisher->addSignal(*sensorSpectralCentroid, [this](float& value){ value = libmapperFrame.spectralCentroid; return true; });
+    libmapperPublisher->addSignal(*sensorPitchYIN, [this](float& value){ value = libmapperFrame.pitchYIN; return true; });
+    libmapperPublisher->addSignal(*sensorLoudness, [this](float& value){ value = libmapperFrame.loudness; return true; });
+    libmapperPublisher->addSignal(*sensorOnsetDetection, [this](float& value){ value = libmapperFrame.onsetDetection; return true; });
+    libmapperPublisher->addSignal(*sensorDissonance, [this](float& value){ value = libmapperFrame.dissonance; return true; });
+
+    // Vector signals are only sent if a new frame has been analysed since their last update
+    for (int i = 0; i < static_cast<int>(sensorsSpectrum.size()); i++){
+        int startBin = i * LIBMAPPER_MAX_VECTOR_LENGTH;
+        libmapperPublisher->addVectorSignal(*sensorsSpectrum[i], LIBMAPPER_MAX_VECTOR_LENGTH,
+            [this, startBin, lastFrame = uint32(0)](float* values) mutable {
+                if(libmapperFrame.frameNumber == lastFrame){
+                    return false;
+                }
+                lastFrame = libmapperFrame.frameNumber;
+                std::copy_n(libmapperFrame.spectrum.begin() + startBin, LIBMAPPER_MAX_VECTOR_LENGTH, values);
+                return true;
+            }, SPECTRUM_PUBLISH_RATE_HZ);
+    }
+    libmapperPublisher->addVectorSignal(*sensorMelBands, NUMBER_OF_MEL_BANDS,
+        [this, lastFrame = uint32(0)](float* values) mutable {
+            if(libmapperFrame.frameNumber == lastFrame){
+                return false;
+            }
+            lastFrame = libmapperFrame.frameNumber;
+            std::copy(libmapperFrame.melBands.begin(), libmapperFrame.melBands.end(), values);
+            return true;
+        }, SPECTRUM_PUBLISH_RATE_HZ);
+
+    for (int band = 0; band < MAX_NUMBER_OF_BANDS; band++){
+        for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++){
+            const auto index = FeatureFrame::getSlotIndex(band, slot);
+            libmapperPublisher->addSignal(bandSlots[band][slot]->getSensor(), [this, index](float& value){
+                value = libmapperFrame.slotValues[index];
+                return libmapperFrame.slotActive[index];
+            });
+        }
+    }
+
+    // Load shedding, so the frontend knows which features are held between updates
+    libmapperPublisher->addVectorSignal(*sensorAnalysisLoad, 1, [this](float* values){
+        *values = libmapperFrame.analysisLoad;
+        return true;
+    }, DIAGNOSTICS_UPDATE_RATE_HZ);
+    // Update rates in Hz of the scheduled features
+    // Sent periodically like the load, so frontends that connect later receive them as well
+    libmapperPublisher->addVectorSignal(*sensorFeatureRates, AnalysisScheduler::NUMBER_OF_FEATURES, [this](float* values){
+        std::copy(libmapperFrame.featureRates.begin(), libmapperFrame.featureRates.end(), values);
+        return true;
+    }, DIAGNOSTICS_UPDATE_RATE_HZ);
+
+    // Debug signals are only sent while enabled, as p50, p99 and max of each stage / slot in turn
+    const auto& profiler = worker->getProfiler();
+    auto writeTimings = [](const TimingHistogram& histogram, float* values){
+        const auto summary = histogram.getSummary();
+        values[0] = summary.p50;
+        values[1] = summary.p99;
+        values[2] = summary.max;
+    };
+    libmapperPublisher->addVectorSignal(*sensorStageTimings, 3 * AnalysisProfiler::NUMBER_OF_STAGES,
+        [this, &profiler, writeTimings](float* values){
+            if(*paramPublishTimings == 0.0f){
+                return false;
+            }
+            for (int stage = 0; stage < AnalysisProfiler::NUMBER_OF_STAGES; stage++){
+                writeTimings(profiler.getStage(static_cast<AnalysisProfiler::Stage>(stage)), values + 3 * stage);
+            }
+            return true;
+        }, DIAGNOSTICS_UPDATE_RATE_HZ);
+    libmapperPublisher->addVectorSignal(*sensorSlotTimings, 3 * MAX_NUMBER_OF_BANDS * NUMBER_OF_SLOTS,
+        [this, &profiler, writeTimings](float* values){
+            if(*paramPublishTimings == 0.0f){
+                return false;
+            }
+            for (int band = 0; band < MAX_NUMBER_OF_BANDS; band++){
+                for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++){
+                    writeTimings(profiler.getSlot(band, slot), values + 3 * FeatureFrame::getSlotIndex(band, slot));
+                }
+            }
+            return true;
+        }, DIAGNOSTICS_UPDATE_RATE_HZ);
+
+    for (int i = 0; i < NUMBER_OF_AUTOMATABLES; i++){
+        auto* param = autoParams[i];
+        libmapperPublisher->addSignal(*sensorsAutomatables[i], [param](float& value){ value = param->load(); return true; });
+    }
+
+    libmapperPublisher->startThread();
+}
+
+void AudioPluginAudioProcessor::createFeatureSlots(mapper::Device* device) {
+    // Clear slots before creating them anew
+    bandSlots.clear();
+    bandSlots.resize(MAX_NUMBER_OF_BANDS);
+
+    for (int band = 0; band < MAX_NUMBER_OF_BANDS; band++){
+        for (int i = 0; i < NUMBER_OF_SLOTS; i++){
+            bandSlots[band].emplace_back(make_unique<FeatureSlotProcessor>(device, magicState, band, analysisWorker->getBandGraph(band), i + 1));
+        }
+    }
 }
 
 TooltipWindow &AudioPluginAudioProcessor::getTooltipWindow() {
@@ -732,16 +835,8 @@ foleys::MagicProcessorState& AudioPluginAudioProcessor::getMagicState() {
     return magicState;
 }
 
-vector<unique_ptr<FeatureSlotProcessor>> &AudioPluginAudioProcessor::getLowBandSlots() {
-    return lowBandSlots;
-}
-
-vector<unique_ptr<FeatureSlotProcessor>> &AudioPluginAudioProcessor::getMidBandSlots() {
-    return midBandSlots;
-}
-
-vector<unique_ptr<FeatureSlotProcessor>> &AudioPluginAudioProcessor::getHighBandSlots() {
-    return highBandSlots;
+vector<vector<unique_ptr<FeatureSlotProcessor>>> &AudioPluginAudioProcessor::getBandSlots() {
+    return bandSlots;
 }
 
 //==============================================================================
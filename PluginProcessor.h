@@ -7,6 +7,7 @@
 #include <juce_dsp/juce_dsp.h>
 #include "external_libraries/essentia/include/algorithmfactory.h"
 #include "Utility.h"
+#include "AllocationTracker.h"
 #include <mapper/mapper_cpp.h>
 #include "foleys_gui_magic/foleys_gui_magic.h"
 #include "BinaryData.h"
@@ -16,6 +17,10 @@
 #include "GUIItems/FeatureSlotGUIItem.h"
 #include "Parameters/MetaParameterFloat.h"
 #include "Parameters/MetaParameterChoice.h"
+#include "Parameters/BandParameterIDs.h"
+#include "Analysis/AnalysisWorker.h"
+#include "Analysis/LinkwitzRileyCrossover.h"
+#include "Publishing/LibmapperPublisher.h"
 
 using namespace juce;
 using namespace std;
@@ -24,11 +29,16 @@ using namespace essentia::standard;
 
 //==============================================================================
 class AudioPluginAudioProcessor  : public juce::AudioProcessor,
-private AudioProcessorValueTreeState::Listener, MultiTimer
+private AudioProcessorValueTreeState::Listener, AnalysisFrameNotifier::Listener, AsyncUpdater
 {
 public:
+    // REALTIME: the plugin in a host, publishing over libmapper and updating the GUI
+    // OFFLINE: driven by the offline tool (see prepareForOfflineAnalysis()), no libmapper device is announced on the
+    // network and no GUI updates are posted
+    enum Mode { REALTIME, OFFLINE };
+
     //==============================================================================
-    AudioPluginAudioProcessor();
+    explicit AudioPluginAudioProcessor(Mode processorMode = REALTIME);
     ~AudioPluginAudioProcessor() override;
 
     //==============================================================================
@@ -65,8 +75,8 @@ public:
     // Pick up changes to the track at which the plugin is located
     void updateTrackProperties(const TrackProperties& properties) override;
 
-    vector<Real>& getSpectrumData();
-    Real& getSpectralCentroid();
+    // Consistent copy of the most recent analysis results, callable from any thread
+    void readFeatureFrame(FeatureFrame& frame) const;
 
     // Getters for filters - used in FilterGraph
     array<dsp::IIR::Filter<float>, 2>& getLowpassFilters();
@@ -77,38 +87,83 @@ public:
     // Getter for magicState
     foleys::MagicProcessorState& getMagicState();
 
-    // Getters for sub band slot processors
-    vector<unique_ptr<FeatureSlotProcessor>>& getLowBandSlots();
-    vector<unique_ptr<FeatureSlotProcessor>>& getMidBandSlots();
-    vector<unique_ptr<FeatureSlotProcessor>>& getHighBandSlots();
+    // Getter for sub band slot processors, one vector per band
+    vector<vector<unique_ptr<FeatureSlotProcessor>>>& getBandSlots();
+
+    /**
+     * Prepare the analysis for rendering a file instead of processing audio in realtime (see Offline/).
+     * The analysis thread and the libmapper publisher (if any) are stopped and the FeatureSlot algorithms are rebuilt
+     * immediately, so the returned worker can be driven synchronously with AnalysisWorker::analyse().
+     * Must be called on the message thread, after the parameters have been set. In OFFLINE mode parameter changes are
+     * only picked up here.
+     */
+    AnalysisWorker& prepareForOfflineAnalysis(double sampleRate, int blockSize);
 
 private:
+    // Parameters of the plugin, including one solo and NUMBER_OF_SLOTS slot selectors per band
+    static AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    // Rename the low/mid/high band parameters of states saved by earlier versions, returns whether any was renamed
+    static bool migrateLegacyParameterIDs(ValueTree& state);
+
+    const Mode mode;
+
     // State management
     AudioProcessorValueTreeState valueTreeState;
-    // Number of audio bands to which to split the main signal
-    // Allows for separate processing of high, mid and low-end
+    // Number of audio bands to which to split the main signal (index of the choice, i.e. number of bands - 1)
+    // Allows for separate processing of up to MAX_NUMBER_OF_BANDS frequency ranges
     atomic<float>* paramNumberOfBands = nullptr;
     // Cutoff frequency for the lowpass filter
-    Value paramLowpassCutoff;
+    atomic<float>* paramLowpassCutoff = nullptr;
     // Cutoff frequency for the highpass filter
-    Value paramHighpassCutoff;
-    atomic<float>* paramLowSolo = nullptr;
-    atomic<float>* paramMidSolo = nullptr;
-    atomic<float>* paramHighSolo = nullptr;
+    atomic<float>* paramHighpassCutoff = nullptr;
+    // Signal used for analysis (left, right, mono, mid or side)
+    atomic<float>* paramAnalysisSource = nullptr;
+    // Solo toggle per band
+    vector<atomic<float>*> paramBandSolos;
+    // Whether soloed bands replace the output (otherwise the plugin is analysis-only)
+    atomic<float>* paramBandMonitoring = nullptr;
+    // Whether the analysis timings are published as libmapper debug signals
+    atomic<float>* paramPublishTimings = nullptr;
     vector<atomic<float>*> autoParams;
 
-    // NB: The cutoff frequencies for the mid-band are calculated from the high- and low band filters respectively
-    // Main filters: 2 for lowpass, 2 for highpass
+    // Band splitting for monitoring soloed bands: LR4 band bank, both channels processed together
+    // The analysis splits its own (decimated) copy of the signal in the AnalysisWorker
+    LinkwitzRileyCrossover crossover;
+    // Whether the crossover processed the previous block, only accessed by the audio thread
+    bool bandMonitoringActive = false;
+    // Butterworth sections of the lowest and highest crossover
+    // Not used for processing, only for displaying the response in the FilterGraph
     array<dsp::IIR::Filter<float>, 2> lowpassFilters;
     array<dsp::IIR::Filter<float>, 2> highpassFilters;
 
-    // Buffers for low, mid and high bands
-    unique_ptr<AudioBuffer<float>> lowBuffer;
-    unique_ptr<AudioBuffer<float>> midBuffer;
-    unique_ptr<AudioBuffer<float>> highBuffer;
+    // Recalculate the crossover and display filters from the current cutoff parameters (message thread)
+    void updateCrossover();
+
+    // Crossover parameters changed since the last update, set by parameterChanged() on any thread
+    atomic<bool> lowpassCutoffChanged { false };
+    atomic<bool> highpassCutoffChanged { false };
+    atomic<bool> numberOfBandsChanged { false };
+    // Snap the cutoffs in 2-band mode, enable the bands in use and update the crossover (message thread)
+    void applyCrossoverParameterChanges();
+
+    // Contiguous storage for all bands, channel c of band b is at getBandChannel(b, c)
+    AudioBuffer<float> bandBuffer;
+    static int getBandChannel(int band, int channel);
+
+    // Analysis hand-over and band monitoring for a chunk of at most the prepared block size
+    // hostSamplePosition and timeMs refer to the chunk's first sample
+    void processSubBlock(AudioBuffer<float>& buffer, int64 hostSamplePosition, double timeMs);
 
-    // Helper function to determine whether any band is currently solo'ed
-    bool noSolo();
+    // Host sample position expected for the next block, used if the host doesn't report one (audio thread)
+    int64 nextHostSamplePosition = 0;
+
+    // Helper function to determine whether any of the first numBands bands is currently solo'ed
+    bool noSolo(int numBands);
+
+    // Number of bands selected by the numberOfBands parameter
+    int getNumberOfBands() const;
+    // Enable the GUI of the bands in use
+    void updateBandsEnabled();
 
     // PluginGUIMagic stuff
     foleys::MagicProcessorState magicState { *this, valueTreeState };
@@ -116,77 +171,59 @@ private:
     // Necessary JUCE component for enabling tooltips
     unique_ptr<TooltipWindow> tooltip;
 
-    // Values estimated by Essentia are marked with an "e" prefix
-    // Will contain copy of the global JUCE audio buffer (not subdivided into bands)
-    // This buffer is used in the calculation of global audio features
-    vector<Real> eGlobalAudioBuffer;
-    // Low, mid and high band buffers
-    vector<Real>   eLowAudioBuffer;
-    vector<Real> eMidAudioBuffer;
-    vector<Real> eHighAudioBuffer;
-
-    // Will contain JUCE audio buffer after windowing
-    vector<Real> windowedFrame;
-    // Will contain the spectrum data
-    vector<Real> eSpectrumData;
-    vector<Real> eMelBands;
-    Real eSpectralCentroid = 0.0f;
-    Real ePitchYIN = 0.0f;
-    Real ePitchConfidence = 0.0f;
-    Real eLoudness = 0.0f;
-    Real eOnsetDetection = 0.0f;
-    vector<Real> eSpectralPeaksFrequencies; // in Hz
-    vector<Real> eSpectralPeaksMagnitudes;
-    vector<Real> eHPCP; // Default size := 12
-    vector<vector<Real>> eChordDetectionInput;
-    vector<string> eChords;
-    vector<Real> eChordsStrengths;
-    string eStrongestChord = ""; // for displaying the best candidate in chord detection
-    Real eDissonance = 0.0f;
-
-
-    // Essentia algorithms are marked by an "a" prefix
-    unique_ptr<Algorithm> aWindowing;
-    unique_ptr<Algorithm> aSpectrum;
-    unique_ptr<Algorithm> aSpectralCentroid;
-    unique_ptr<Algorithm> aPitchYIN;
-    unique_ptr<Algorithm> aLoudness;
-    unique_ptr<Algorithm> aOnsetDetection;
-    unique_ptr<Algorithm> aSpectralPeaks;
-    unique_ptr<Algorithm> aChordsDetection;
-    unique_ptr<Algorithm> aDissonance; // Outputs sensory dissonance on a scale from 0 (consonant) to 1 (dissonant)
-    unique_ptr<Algorithm> aMFCC;
-
-    // Currently unused algorithms
-    // unique_ptr<Algorithm> aHPCP; // Harmonic Pitch Class Profile
-    // unique_ptr<Algorithm> aMelBands;
-
+    // Analysis thread, owns the Essentia algorithms and computes all features
+    unique_ptr<AnalysisWorker> analysisWorker;
 
     // Libmapper related fields
     // Initialise the libmapper device and its global signals
     void libmapperSetup(const string& deviceName);
+    // Create the FeatureSlots of all bands, with a libmapper signal each if a device is given
+    void createFeatureSlots(mapper::Device* device);
     unique_ptr<mapper::Device> libmapperDevice;
     unique_ptr<mapper::Signal> sensorSpectralCentroid;
-    unique_ptr<mapper::Signal> sensorSpectrum;
+    // Log-spaced spectrum, split into chunks of LIBMAPPER_MAX_VECTOR_LENGTH bins ("spectrum_1", "spectrum_2", ...)
+    vector<unique_ptr<mapper::Signal>> sensorsSpectrum;
+    unique_ptr<mapper::Signal> sensorMelBands;
     unique_ptr<mapper::Signal> sensorLoudness;
     unique_ptr<mapper::Signal> sensorOnsetDetection;
     unique_ptr<mapper::Signal> sensorDissonance;
+    // Delay between the audio a frame describes and the newest audio it contains, in seconds
+    unique_ptr<mapper::Signal> sensorAnalysisLatency;
     vector<unique_ptr<mapper::Signal>> sensorsAutomatables;
     unique_ptr<mapper::Signal> sensorPitchYIN;
-
-    // Currently unused sensor
-    // unique_ptr<mapper::Signal> sensorMelBands;
-
-    // Feature slots
-    vector<unique_ptr<FeatureSlotProcessor>> lowBandSlots;
-    vector<unique_ptr<FeatureSlotProcessor>> midBandSlots;
-    vector<unique_ptr<FeatureSlotProcessor>> highBandSlots;
+    // Smoothed load of the analysis thread and the update rate of each AnalysisScheduler::Feature
+    unique_ptr<mapper::Signal> sensorAnalysisLoad;
+    unique_ptr<mapper::Signal> sensorFeatureRates;
+    // Debug signals: p50, p99 and max in µs of each AnalysisProfiler stage and of each FeatureSlot
+    unique_ptr<mapper::Signal> sensorStageTimings;
+    unique_ptr<mapper::Signal> sensorSlotTimings;
+    // Sends all signals and polls the device, the only thread accessing libmapper after the setup
+    unique_ptr<LibmapperPublisher> libmapperPublisher;
+    // Snapshot of the results sent in the current batch, only accessed by the publisher thread
+    FeatureFrame libmapperFrame;
+
+    // Feature slots, NUMBER_OF_SLOTS for each of the MAX_NUMBER_OF_BANDS bands
+    vector<vector<unique_ptr<FeatureSlotProcessor>>> bandSlots;
 
     // Called if one of the parameters is changed, either through UI interaction or
-    // manipulation from the host (such as automations)
+    // manipulation from the host (such as automations). Automation may call it on the audio thread, so changes are only
+    // recorded here and applied in handleAsyncUpdate()
     void parameterChanged(const String& parameterID, float newValue) override;
 
-    void timerCallback(int timerID) override;
+    // Called on the analysis thread for every new frame, schedules a GUI update if the last one is long enough ago
+    void analysisFrameReady() override;
+    // Earliest time of the next GUI update, only accessed by the analysis thread
+    double nextGUIUpdate = 0.0;
+    // Snapshot of the results displayed in the GUI, only accessed by the message thread
+    FeatureFrame guiFrame;
+
+    // Applies parameter changes and displays the current feature values in the GUI
+    void handleAsyncUpdate() override;
+
+    // Displays the analysis timings in the diagnostics panel, at most at DIAGNOSTICS_UPDATE_RATE_HZ
+    void updateDiagnostics();
+    // Earliest time of the next diagnostics update, only accessed by the message thread
+    double nextDiagnosticsUpdate = 0.0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessor)
     //==============================================================================
@@ -197,9 +234,10 @@ static Identifier SPECTRAL_CENTROID_ID = "spectralCentroidValue";
 static Identifier PITCH_YIN_ID = "pitchYINValue";
 static Identifier MID_MAX_WIDTH_ID = "midMaxWidth";
 static Identifier MULTIBAND_ENABLED_ID = "multiBandEnabled";
-static Identifier MIDBAND_ENABLED_ID = "midBandEnabled";
 static Identifier LOUDNESS_ID = "loudnessValue";
 static Identifier ODF_ID = "onsetDetectionValue";
 static Identifier STRONGEST_CHORD_ID = "strongestChordValue";
 static Identifier DISSONANCE_ID = "dissonance";
+static Identifier SLOWEST_SLOT_TIMING_ID = "timingSlowestSlot";
+static Identifier LOAD_SHEDDING_ID = "loadShedding";
 #endif
\ No newline at end of file
@@ -0,0 +1,106 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#include "LibmapperPublisher.h"
+
+LibmapperPublisher::LibmapperPublisher(mapper::Device& dev, AnalysisFrameNotifier& notifier)
+        : Thread("music-vis-backend libmapper"), device(dev), frameNotifier(notifier) {
+    frameNotifier.addListener(this);
+}
+
+LibmapperPublisher::~LibmapperPublisher() {
+    frameNotifier.removeListener(this);
+    stopThread(LIBMAPPER_THREAD_STOP_TIMEOUT_MS);
+}
+
+void LibmapperPublisher::addSignal(mapper::Signal& signal, ValueReader reader) {
+    addVectorSignal(signal, 1, [reader = move(reader)](float* values){ return reader(*values); });
+}
+
+void LibmapperPublisher::addVectorSignal(mapper::Signal& signal, int length, VectorReader reader, int maxRateHz) {
+    jassert(!isThreadRunning());
+    jassert(length > 0 && length <= LIBMAPPER_MAX_VECTOR_LENGTH);
+    const auto interval = maxRateHz > 0 ? 1000.0 / maxRateHz : 0.0;
+    outputs.push_back({ &signal, move(reader), vector<float>(static_cast<size_t>(length), 0.0f), interval, 0.0 });
+}
+
+void LibmapperPublisher::clearSignals() {
+    jassert(!isThreadRunning());
+    outputs.clear();
+}
+
+void LibmapperPublisher::setBatchReader(BatchReader reader) {
+    jassert(!isThreadRunning());
+    batchReader = move(reader);
+}
+
+void LibmapperPublisher::setMaxRate(double rateHz) {
+    jassert(rateHz > 0.0);
+    minInterval.store(1000.0 / rateHz);
+}
+
+void LibmapperPublisher::analysisFrameReady() {
+    framePending.store(true);
+    notify();
+}
+
+void LibmapperPublisher::run() {
+    double nextPublish = 0.0;
+
+    while (!threadShouldExit()){
+        // Sleep until a frame is ready, but keep serving incoming messages (e.g. map requests) while idle
+        if(!framePending.load()){
+            wait(LIBMAPPER_IDLE_POLL_INTERVAL_MS);
+        }
+        if(threadShouldExit()){
+            break;
+        }
+
+        const auto now = Time::getMillisecondCounterHiRes();
+        if(!framePending.load()){
+            device.poll(0);
+        } else if(now < nextPublish){
+            // Too early, frames arriving until then are sent together with the latest values
+            wait(static_cast<int>(std::ceil(nextPublish - now)));
+        } else {
+            framePending.store(false);
+            publish();
+            nextPublish = now + minInterval.load();
+        }
+    }
+}
+
+void LibmapperPublisher::publish() {
+    const auto now = Time::getMillisecondCounterHiRes();
+
+    // Bundle all updates of this tick into one message with a common timetag
+    mapper::Timetag timetag;
+    double timeMs;
+    if(batchReader && batchReader(timeMs)){
+        // Shift the timetag back to the time the values refer to, so receivers can align them with the audio
+        timetag = mapper::Timetag(static_cast<double>(timetag) + (timeMs - now) / 1000.0);
+    }
+    device.start_queue(timetag);
+
+    for (auto& output : outputs){
+        // Rate limited signals wait for their next slot
+        if(now < output.nextUpdate || !output.reader(output.values.data())){
+            continue;
+        }
+
+        if(output.values.size() == 1){
+            output.signal->update(output.values[0], timetag);
+        } else {
+            output.signal->update(output.values.data(), 1, timetag);
+        }
+
+        // Advance by the interval instead of restarting from now, so the average rate is kept even though the ticks
+        // don't line up with it. After an idle period at most one update is sent early.
+        output.nextUpdate = jmax(output.nextUpdate, now - output.interval) + output.interval;
+    }
+
+    device.send_queue(timetag);
+    // Handle incoming messages (e.g. map requests) once per tick without blocking
+    device.poll(0);
+}
@@ -0,0 +1,108 @@
+//
+// Created by Max on 17/10/2026.
+//
+
+#ifndef MUSIC_VIS_BACKEND_LIBMAPPERPUBLISHER_H
+#define MUSIC_VIS_BACKEND_LIBMAPPERPUBLISHER_H
+
+#include <functional>
+#include <juce_core/juce_core.h>
+#include <mapper/mapper_cpp.h>
+#include "../Constants.h"
+#include "../Analysis/AnalysisFrameNotifier.h"
+
+using namespace std;
+using namespace juce;
+
+/**
+ * Dedicated thread that owns all communication with the libmapper device.
+ * It sleeps until the analysis reports a new frame, then reads the latest values of all registered signals, sends them
+ * as one queued batch and polls the device once. Frames arriving faster than the maximum rate are coalesced into one
+ * batch. Without new frames the device is only polled every LIBMAPPER_IDLE_POLL_INTERVAL_MS.
+ * Signal values are only read through the registered callbacks, which must be lock-free (e.g. atomic loads), so
+ * neither the message thread nor the analysis thread ever touch libmapper.
+ */
+class LibmapperPublisher : public Thread, private AnalysisFrameNotifier::Listener {
+public:
+    /**
+     * Callback returning the current value of a signal
+     * @param value Set to the value to publish
+     * @return false if there is currently nothing to publish for the signal
+     */
+    using ValueReader = function<bool(float& value)>;
+
+    /**
+     * Callback filling all values of a vector signal
+     * @param values Destination for as many values as the signal's length
+     * @return false if there is currently nothing (new) to publish for the signal
+     */
+    using VectorReader = function<bool(float* values)>;
+
+    /**
+     * Callback called at the start of every batch, before the signals' readers. Typically takes a snapshot of the
+     * results the readers then return, so all values of a batch belong together.
+     * @param timeMs Set to the time the values of the batch refer to, on the Time::getMillisecondCounterHiRes() clock
+     * @return false if the batch should be timetagged with the time it is sent
+     */
+    using BatchReader = function<bool(double& timeMs)>;
+
+    LibmapperPublisher(mapper::Device& device, AnalysisFrameNotifier& frameNotifier);
+    ~LibmapperPublisher() override;
+
+    /**
+     * Register a signal to be updated on every tick. Must only be called while the thread is stopped.
+     * @param signal Output signal of the device, must outlive the publisher thread
+     * @param reader Lock-free callback returning the signal's current value
+     */
+    void addSignal(mapper::Signal& signal, ValueReader reader);
+
+    /**
+     * Register a vector signal. Must only be called while the thread is stopped.
+     * @param signal Output signal of the device, must outlive the publisher thread
+     * @param length Number of values of the signal
+     * @param reader Lock-free callback filling the signal's current values
+     * @param maxRateHz Maximum number of updates per second (on average), 0 to update on every tick
+     */
+    void addVectorSignal(mapper::Signal& signal, int length, VectorReader reader, int maxRateHz = 0);
+
+    // Remove all registered signals. Must only be called while the thread is stopped.
+    void clearSignals();
+
+    // Set the callback preparing each batch. Must only be called while the thread is stopped.
+    void setBatchReader(BatchReader reader);
+
+    // Set the maximum number of batches sent per second
+    void setMaxRate(double rateHz);
+
+    void run() override;
+
+private:
+    // Wakes up the thread, called on the analysis thread
+    void analysisFrameReady() override;
+
+    // Send all values in one batch and poll the device
+    void publish();
+
+    mapper::Device& device;
+    AnalysisFrameNotifier& frameNotifier;
+    // Set by the analysis thread, cleared once the frame has been published
+    atomic<bool> framePending { false };
+    atomic<double> minInterval { 1000.0 / LIBMAPPER_MAX_PUBLISH_RATE_HZ };
+
+    struct Output {
+        mapper::Signal* signal;
+        VectorReader reader;
+        // Preallocated storage for the values read on each tick
+        vector<float> values;
+        // Minimum time between two updates and time of the next allowed update (ms)
+        double interval;
+        double nextUpdate;
+    };
+    vector<Output> outputs;
+    BatchReader batchReader;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibmapperPublisher)
+};
+
+
+#endif //MUSIC_VIS_BACKEND_LIBMAPPERPUBLISHER_H
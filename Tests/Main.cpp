@@ -0,0 +1,26 @@
+//
+// Created by Max on 17/10/2026.
+// Runs all unit tests, registered with ctest (see readme.md)
+//
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+int main(int argc, char* argv[]) {
+    // An optional argument restricts the run to one category, e.g. "Analysis"
+    UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    if(argc > 1){
+        runner.runTestsInCategory(argv[1]);
+    } else {
+        runner.runAllTests();
+    }
+
+    for (int i = 0; i < runner.getNumResults(); i++){
+        if(runner.getResult(i)->failures > 0){
+            return 1;
+        }
+    }
+    return 0;
+}
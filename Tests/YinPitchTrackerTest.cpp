@@ -0,0 +1,110 @@
+//
+// Created by Max on 17/10/2026.
+// Checks the analysis' YinPitchTracker against Essentia's PitchYin, which it replaces
+//
+
+#include <juce_core/juce_core.h>
+#include "../external_libraries/essentia/include/algorithmfactory.h"
+#include "../Analysis/YinPitchTracker.h"
+
+using namespace std;
+using namespace juce;
+using namespace essentia;
+
+// Maximum differences between Essentia's PitchYin and the YinPitchTracker per frame: relative pitch (only compared if both
+// are confident) and absolute confidence, and the fraction of frames of the sweep allowed to exceed them (octave jumps at
+// the sweep's ends may be resolved differently)
+static const float PITCH_CHECK_FREQUENCY_TOLERANCE = 0.01f;
+static const float PITCH_CHECK_CONFIDENCE_TOLERANCE = 0.05f;
+static const double PITCH_CHECK_MAX_MISMATCHES = 0.02;
+
+class YinPitchTrackerTest : public UnitTest {
+public:
+    YinPitchTrackerTest() : UnitTest("YinPitchTracker", "Analysis") {}
+
+    void initialise() override {
+        essentia::init();
+    }
+
+    void shutdown() override {
+        essentia::shutdown();
+    }
+
+    void runTest() override {
+        const auto sampleRate = ANALYSIS_TARGET_SAMPLE_RATE;
+        vector<Real> frame(ANALYSIS_FRAME_SIZE, 0.0f);
+        Real essentiaPitch = 0.0f, essentiaConfidence = 0.0f, trackerPitch = 0.0f, trackerConfidence = 0.0f;
+
+        unique_ptr<standard::Algorithm> pitchYin(standard::AlgorithmFactory::instance().create(
+                "PitchYin", "sampleRate", sampleRate, "frameSize", ANALYSIS_FRAME_SIZE));
+        pitchYin->input("signal").set(frame);
+        pitchYin->output("pitch").set(essentiaPitch);
+        pitchYin->output("pitchConfidence").set(essentiaConfidence);
+
+        YinPitchTracker tracker;
+        tracker.prepare(sampleRate, ANALYSIS_FRAME_SIZE);
+
+        auto analyse = [&](){
+            pitchYin->compute();
+            tracker.process(frame, trackerPitch, trackerConfidence);
+        };
+        auto agrees = [&](){
+            // The pitch of an unconfident estimate is arbitrary
+            const auto isConfident = essentiaConfidence > 0.5f && trackerConfidence > 0.5f;
+            return (!isConfident || abs(trackerPitch - essentiaPitch) <= PITCH_CHECK_FREQUENCY_TOLERANCE * essentiaPitch)
+                   && abs(trackerConfidence - essentiaConfidence) <= PITCH_CHECK_CONFIDENCE_TOLERANCE;
+        };
+
+        beginTest("Silent frame");
+        {
+            std::fill(frame.begin(), frame.end(), 0.0f);
+            analyse();
+            expectEquals(trackerPitch, 0.0f);
+            expectEquals(trackerConfidence, 0.0f);
+            expectEquals(trackerPitch, essentiaPitch);
+            expectEquals(trackerConfidence, essentiaConfidence);
+        }
+
+        beginTest("Exponential sweep");
+        {
+            // 40 Hz to 16 kHz over 2 seconds, compared frame by frame at the analysis hop
+            const auto seconds = 2.0;
+            const auto startFrequency = 40.0;
+            const auto endFrequency = jmin(16000.0, 0.45 * sampleRate);
+            const auto sweepRate = log(endFrequency / startFrequency) / seconds;
+            vector<float> sweep(static_cast<size_t>(roundToInt(sampleRate * seconds)));
+            for (size_t i = 0; i < sweep.size(); i++){
+                const auto time = static_cast<double>(i) / sampleRate;
+                sweep[i] = 0.5f * static_cast<float>(sin(MathConstants<double>::twoPi * startFrequency * (exp(sweepRate * time) - 1.0) / sweepRate));
+            }
+
+            int numFrames = 0, numMismatches = 0;
+            for (size_t startSample = 0; startSample + ANALYSIS_FRAME_SIZE <= sweep.size(); startSample += ANALYSIS_HOP_SIZE){
+                std::copy_n(sweep.begin() + static_cast<long>(startSample), ANALYSIS_FRAME_SIZE, frame.begin());
+                analyse();
+                numMismatches += agrees() ? 0 : 1;
+                numFrames++;
+            }
+            expect(numFrames > 0);
+            expect(numMismatches <= PITCH_CHECK_MAX_MISMATCHES * numFrames,
+                   String(numMismatches) + " of " + String(numFrames) + " frames differ from PitchYin");
+        }
+
+        beginTest("Pitch near the longest lag");
+        {
+            // The longest lag searched is limited by the window of half a frame, so the period is chosen just below it
+            const auto period = ANALYSIS_FRAME_SIZE / 2 - 24;
+            const auto frequency = static_cast<float>(sampleRate / period);
+            for (int i = 0; i < ANALYSIS_FRAME_SIZE; i++){
+                frame[static_cast<size_t>(i)] = 0.5f * static_cast<float>(sin(MathConstants<double>::twoPi * i / period));
+            }
+            analyse();
+            expect(trackerConfidence > 0.5f, "Confidence " + String(trackerConfidence));
+            expectWithinAbsoluteError(trackerPitch, frequency, PITCH_CHECK_FREQUENCY_TOLERANCE * frequency);
+            expect(agrees(), "Tracker " + String(trackerPitch) + " Hz / " + String(trackerConfidence)
+                             + ", PitchYin " + String(essentiaPitch) + " Hz / " + String(essentiaConfidence));
+        }
+    }
+};
+
+static YinPitchTrackerTest yinPitchTrackerTest;
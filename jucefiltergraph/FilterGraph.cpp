@@ -78,38 +78,27 @@ void FilterGraph::paint (Graphics& g)
     g.setGradientFill (ColourGradient (Colour (0xff232338), width / 2, height / 2, Colour (0xff21222a), 2.5f, height / 2, true));
     g.fillRect (2.5f, 2.5f, width - 5, height - 5);
 
-    for (FilterInfo& filterInfo : filterVector){
-        // Clear trace path
-        tracePath.clear();
+    // The responses are only evaluated again if a filter changed since the last paint
+    updateTraces();
 
-        if (traceType == Magnitude)
-        {
-            const float scaleFactor = (((height / 2) - (height - 5) / (numHorizontalLines + 1) - 2.5f) / maxdB);
-
-            float traceMagnitude = float(filterInfo.getResponse(lowFreq).magnitudeValue);
-            traceMagnitude = 20 * log10 (traceMagnitude);
-
-            tracePath.startNewSubPath (2.5f, (height / 2) - (traceMagnitude * scaleFactor));
+    g.setColour (Colour (0x80ffffff));
+    g.strokePath (sumTrace.path, PathStrokeType (1.5f));
 
-            for (float xPos = 3.5; xPos < (width - 2.5); xPos += 1.0f)
-            {
-                const float freq = xToFreq (xPos);
-
-                traceMagnitude = float(filterInfo.getResponse(freq).magnitudeValue);
-                // Convert to dB
-                traceMagnitude = 20 * log10 (traceMagnitude);
-                // Trace path
-                tracePath.lineTo (xPos, (height / 2) - (traceMagnitude * scaleFactor));
-            }
-        }
+    // The inner bands blend from the lowpass to the highpass colour
+    for (int band = 0; band < numInnerBandTraces; band++){
+        const auto proportion = float(band + 1) / float(numInnerBandTraces + 1);
+        g.setColour (traceColour.interpolatedWith (traceColour.contrasting(), proportion));
+        g.strokePath (innerBandTraces[band], PathStrokeType (2.0f));
+    }
 
+    for (int filter = 0; filter < filterVector.size(); filter++){
         // DRAW
-        if(filterInfo.getFilterType() == FilterInfo::FilterType::LOWPASS){
+        if(filterVector[filter].getFilterType() == FilterInfo::FilterType::LOWPASS){
             g.setColour (traceColour);
         } else {
             g.setColour(traceColour.contrasting());
         }
-        g.strokePath (tracePath, PathStrokeType (3.0f));
+        g.strokePath (cachedTraces[filter].path, PathStrokeType (3.0f));
     }
     
     // paint the display grid lines ===============================================================================
@@ -159,10 +148,127 @@ void FilterGraph::paint (Graphics& g)
 
 void FilterGraph::resized()
 {
+    updateColumnFrequencies();
+    tracesValid = false;
+}
+
+void FilterGraph::updateColumnFrequencies()
+{
+    const auto width = float(getWidth());
+    columnFrequencies.clear();
+    columnMagnitudes.clear();
+    if (width <= 5.0f)
+        return;
+
+    // One entry per column of the trace, each a constant ratio above the previous one
+    const auto ratio = pow (double (highFreq) / lowFreq, 1.0 / (width - 5.0));
+    double freq = lowFreq;
+    for (float xPos = 2.5f; xPos < (width - 2.5f); xPos += 1.0f)
+    {
+        columnFrequencies.push_back (float (freq));
+        freq *= ratio;
+    }
+
+    // Evaluating the traces never allocates
+    columnMagnitudes.resize (columnFrequencies.size());
+    responseScratch.prepare (int (columnFrequencies.size()));
+}
+
+void FilterGraph::updateTraces()
+{
+    cachedTraces.resize (filterVector.size());
+    const auto numColumns = int (columnFrequencies.size());
+
+    for (int filter = 0; filter < filterVector.size(); filter++)
+    {
+        auto& filterInfo = filterVector[filter];
+        auto& cachedTrace = cachedTraces[filter];
+        if (tracesValid && cachedTrace.key == filterInfo.getCoefficients())
+            continue;
+
+        cachedTrace.key = filterInfo.getCoefficients();
+        cachedTrace.path.clear();
+
+        if (traceType == Magnitude)
+        {
+            // Evaluate all columns at once
+            filterInfo.getResponses (columnFrequencies.data(), columnMagnitudes.data(), nullptr, numColumns, responseScratch);
+            buildTrace (cachedTrace.path);
+        }
+    }
+
+    // The band bank's sum and inner bands, with the phase compensation used when soloed bands are monitored
+    array<float, MAX_NUMBER_OF_BANDS - 1> crossoverFrequencies {};
+    const auto numCrossovers = getCrossoverFrequencies (crossoverFrequencies);
+    const Array<float> crossoverKey (crossoverFrequencies.data(), numCrossovers);
+    if (! tracesValid || sumTrace.key != crossoverKey)
+    {
+        sumTrace.key = crossoverKey;
+        sumTrace.path.clear();
+        numInnerBandTraces = 0;
+
+        if (traceType == Magnitude && numCrossovers > 0)
+        {
+            FilterInfo::getCrossoverSumResponses (crossoverFrequencies.data(), numCrossovers, true, fs,
+                                                  columnFrequencies.data(), columnMagnitudes.data(), nullptr,
+                                                  numColumns, responseScratch);
+            buildTrace (sumTrace.path);
+
+            // Band 0 and band numCrossovers are shown by the lowpass and highpass traces
+            numInnerBandTraces = numCrossovers - 1;
+            for (int band = 1; band < numCrossovers; band++)
+            {
+                FilterInfo::getCrossoverBandResponses (crossoverFrequencies.data(), numCrossovers, true, fs, band,
+                                                       columnFrequencies.data(), columnMagnitudes.data(), nullptr,
+                                                       numColumns, responseScratch);
+                innerBandTraces[band - 1].clear();
+                buildTrace (innerBandTraces[band - 1]);
+            }
+        }
+    }
+
+    tracesValid = true;
+}
+
+void FilterGraph::buildTrace (Path& path)
+{
+    const auto height = float(getHeight());
+    const float scaleFactor = (((height / 2) - (height - 5) / (numHorizontalLines + 1) - 2.5f) / maxdB);
+
+    for (int column = 0; column < columnMagnitudes.size(); column++)
+    {
+        const float xPos = 2.5f + column;
+        // Convert to dB
+        const float traceMagnitude = 20 * log10 (columnMagnitudes[column]);
+        const float yPos = (height / 2) - (traceMagnitude * scaleFactor);
+
+        // Trace path
+        if (column == 0)
+            path.startNewSubPath (xPos, yPos);
+        else
+            path.lineTo (xPos, yPos);
+    }
+}
+
+int FilterGraph::getCrossoverFrequencies (array<float, MAX_NUMBER_OF_BANDS - 1>& frequencies) const
+{
+    // Same spacing as the processor: the parameter holds the index of the choice, one less than the number of bands
+    const auto numCrossovers = jlimit (0, MAX_NUMBER_OF_BANDS - 1, roundToInt (numberOfBands->load()));
+    const auto lowCutoff = float (lowpassCutoff.getValue());
+    // In 2-band mode the highpass cutoff follows the lowpass cutoff
+    const auto highCutoff = numCrossovers > 1 ? jmax (lowCutoff, float (highpassCutoff.getValue())) : lowCutoff;
+    LinkwitzRileyCrossover::getLogSpacedFrequencies (lowCutoff, highCutoff, numCrossovers, frequencies.data());
+    return numCrossovers;
 }
 
 float FilterGraph::xToFreq (float xPos) const
 {
+    // Interpolate between the neighbouring columns, the frequencies are close enough for linear interpolation
+    const auto position = xPos - 2.5f;
+    const auto column = int (floor (position));
+    if (column >= 0 && column + 1 < int (columnFrequencies.size()))
+        return jmap (position - column, columnFrequencies[column], columnFrequencies[column + 1]);
+
 	const auto width = float(getWidth());
     return lowFreq * pow ((highFreq / lowFreq), ((xPos - 2.5f) / (width - 5.0f)));
 }
@@ -179,6 +285,19 @@ void FilterGraph::setTraceColour (Colour newColour)
     repaint();
 }
 
+void FilterGraph::setSampleRate (double sampleRate)
+{
+    if (sampleRate == fs)
+        return;
+
+    fs = sampleRate;
+    for (auto& filterInfo : filterVector)
+        filterInfo.setSampleRate (sampleRate);
+
+    tracesValid = false;
+    repaint();
+}
+
 void FilterGraph::mouseMove (const MouseEvent &event)
 {    
     repaint();
@@ -204,8 +323,8 @@ void FilterGraph::mouseDrag(const MouseEvent& event)
         updateFilter(0, freq);
         updateFilter(1, freq);
     }
-    // 3 bands
-    else if (*numberOfBands == 2.0f){
+    // 3 or more bands: the lowest and highest crossover are dragged, those in between follow
+    else if (*numberOfBands >= 2.0f){
         // Update filter coefficients
         updateFilter(selectedFilterDragging, freq);
     }
@@ -269,6 +388,10 @@ void FilterGraph::parameterChanged(const String& parameterID, float newValue)
         // Repaint asynchronously
         sendChangeMessage();
     }
+    if (parameterID == "numberOfBands") {
+        // The band bank's sum depends on the number of bands
+        sendChangeMessage();
+    }
 }
 
 void FilterGraph::changeListenerCallback(ChangeBroadcaster* source)
@@ -12,6 +12,7 @@
 #define FILTER_GRAPH_H
 
 #include "FilterInfo.h"
+#include "../Analysis/LinkwitzRileyCrossover.h"
 
 
 using namespace std;
@@ -45,12 +46,15 @@ public:
     void paint (Graphics&) override;
     void resized() override;
 
-	// Convert from point on component to frequency
+	// Convert from point on component to frequency (looked up in columnFrequencies within the trace)
     float xToFreq (float xPos) const;
 	// Convert frequency to point on component
     float freqToX (float freq) const;
 
     void setTraceColour (Colour newColour);
+
+    // Update the sample rate the responses are evaluated at
+    void setSampleRate (double sampleRate);
     
     float maxdB, maxPhas;
     Colour traceColour;
@@ -105,7 +109,35 @@ private:
     vector <FilterInfo> filterVector;
 
 	// Paths for the grid display and trace of filter response
-    Path gridPath, tracePath;
+    Path gridPath;
+
+    // Frequency at each column of the trace (x = 2.5 + index), rebuilt when the component is resized
+    vector<float> columnFrequencies;
+    void updateColumnFrequencies();
+
+    // Response trace, only rebuilt if what it depends on (coefficients or crossover frequencies), the sample rate or the
+    // size changed
+    struct CachedTrace {
+        Path path;
+        Array<float> key;
+    };
+    // One trace per filter
+    vector<CachedTrace> cachedTraces;
+    // Sum of all bands of the band bank, shows how the bands reconstruct the input
+    CachedTrace sumTrace;
+    // Bands between the lowest and the highest crossover (the outer bands are the filter traces), rebuilt with sumTrace
+    array<Path, MAX_NUMBER_OF_BANDS - 2> innerBandTraces;
+    int numInnerBandTraces = 0;
+    // Scratch buffers for the magnitudes of one trace and the response evaluation, prepared on resize
+    vector<float> columnMagnitudes;
+    FilterInfo::ResponseScratch responseScratch;
+    bool tracesValid = false;
+    void updateTraces();
+    // Replace the trace's path with the curve of columnMagnitudes
+    void buildTrace(Path& path);
+
+    // Crossover frequencies of the band bank for the current parameters, returns the number of crossovers
+    int getCrossoverFrequencies(array<float, MAX_NUMBER_OF_BANDS - 1>& frequencies) const;
 
 	// Callback methods invoked on parameter / UI change
     void parameterChanged(const String& parameterID, float newValue) override;
@@ -10,6 +10,154 @@
 
 #include "FilterInfo.h"
 
+namespace
+{
+    using SIMDFloat = FilterInfo::ResponseScratch::SIMDFloat;
+
+    // Complex values of a batch of frequencies, one lane per frequency, stored in the caller's scratch buffers
+    struct ComplexBlock
+    {
+        SIMDFloat* re;
+        SIMDFloat* im;
+    };
+
+    // Biquad coefficients normalised by a0
+    struct Biquad
+    {
+        float b0, b1, b2, a1, a2;
+    };
+
+    Biquad toBiquad (const Array<float>& coefficients)
+    {
+        // Coefficients are normalised by a0: b0, b1, b2, a1, a2
+        jassert (coefficients.size() == 5);
+        return { coefficients[0], coefficients[1], coefficients[2], coefficients[3], coefficients[4] };
+    }
+
+    // Butterworth sections of the band bank, the same designs as dsp::IIR::Coefficients::makeLowPass(),
+    // makeHighPass() and makeAllPass(), but without allocating a coefficients object
+    Biquad makeLowPass (double sampleRate, double frequency)
+    {
+        const auto n = 1.0 / tan (MathConstants<double>::pi * frequency / sampleRate);
+        const auto c1 = 1.0 / (1.0 + n / SQRT_2_OVER_2 + n * n);
+        return { float (c1), float (c1 * 2.0), float (c1), float (c1 * 2.0 * (1.0 - n * n)), float (c1 * (1.0 - n / SQRT_2_OVER_2 + n * n)) };
+    }
+
+    Biquad makeHighPass (double sampleRate, double frequency)
+    {
+        const auto n = tan (MathConstants<double>::pi * frequency / sampleRate);
+        const auto c1 = 1.0 / (1.0 + n / SQRT_2_OVER_2 + n * n);
+        return { float (c1), float (c1 * -2.0), float (c1), float (c1 * 2.0 * (n * n - 1.0)), float (c1 * (1.0 - n / SQRT_2_OVER_2 + n * n)) };
+    }
+
+    Biquad makeAllPass (double sampleRate, double frequency)
+    {
+        const auto n = 1.0 / tan (MathConstants<double>::pi * frequency / sampleRate);
+        const auto c1 = 1.0 / (1.0 + n / SQRT_2_OVER_2 + n * n);
+        const auto b0 = float (c1 * (1.0 - n / SQRT_2_OVER_2 + n * n));
+        const auto b1 = float (c1 * 2.0 * (1.0 - n * n));
+        return { b0, b1, 1.0f, b1, b0 };
+    }
+
+    // Compute e^-jw and e^-2jw of a batch of frequencies once, they are shared by all filters evaluated on it
+    // Returns the number of SIMD blocks in use
+    size_t setFrequencies (FilterInfo::ResponseScratch& w, const float* frequencies, int numFrequencies, double sampleRate)
+    {
+        const auto numBlocks = (size_t (numFrequencies) + SIMDFloat::size() - 1) / SIMDFloat::size();
+        jassert (numBlocks <= w.cosW.size());
+
+        // The lanes after the last frequency are evaluated at DC and ignored
+        for (size_t block = 0; block < numBlocks; block++)
+        {
+            for (size_t lane = 0; lane < SIMDFloat::size(); lane++)
+            {
+                const auto index = block * SIMDFloat::size() + lane;
+                const auto omega = index < size_t (numFrequencies) ? MathConstants<double>::twoPi * frequencies[index] / sampleRate : 0.0;
+                w.cosW[block].set (lane, float (cos (omega)));
+                w.sinW[block].set (lane, float (sin (omega)));
+            }
+
+            // Double angle identities, no further trigonometric functions needed
+            w.cos2W[block] = w.cosW[block] * w.cosW[block] * SIMDFloat::expand (2.0f) - SIMDFloat::expand (1.0f);
+            w.sin2W[block] = w.sinW[block] * w.cosW[block] * SIMDFloat::expand (2.0f);
+        }
+
+        return numBlocks;
+    }
+
+    void fillBlock (ComplexBlock block, size_t numBlocks, float re)
+    {
+        for (size_t i = 0; i < numBlocks; i++)
+        {
+            block.re[i] = SIMDFloat::expand (re);
+            block.im[i] = SIMDFloat::expand (0.0f);
+        }
+    }
+
+    void copyBlock (ComplexBlock source, ComplexBlock dest, size_t numBlocks)
+    {
+        std::copy (source.re, source.re + numBlocks, dest.re);
+        std::copy (source.im, source.im + numBlocks, dest.im);
+    }
+
+    void addBlock (ComplexBlock source, ComplexBlock dest, size_t numBlocks)
+    {
+        for (size_t i = 0; i < numBlocks; i++)
+        {
+            dest.re[i] += source.re[i];
+            dest.im[i] += source.im[i];
+        }
+    }
+
+    // Multiply the block by the response of a biquad, H = (b0 + b1 e^-jw + b2 e^-2jw) / (1 + a1 e^-jw + a2 e^-2jw)
+    void multiplyByBiquad (ComplexBlock block, const FilterInfo::ResponseScratch& w, size_t numBlocks, const Biquad& biquad)
+    {
+        const auto b0 = SIMDFloat::expand (biquad.b0);
+        const auto b1 = SIMDFloat::expand (biquad.b1);
+        const auto b2 = SIMDFloat::expand (biquad.b2);
+        const auto a1 = SIMDFloat::expand (biquad.a1);
+        const auto a2 = SIMDFloat::expand (biquad.a2);
+        const auto one = SIMDFloat::expand (1.0f);
+
+        for (size_t i = 0; i < numBlocks; i++)
+        {
+            const auto numRe = b0 + b1 * w.cosW[i] + b2 * w.cos2W[i];
+            const auto numIm = SIMDFloat::expand (0.0f) - (b1 * w.sinW[i] + b2 * w.sin2W[i]);
+            const auto denRe = one + a1 * w.cosW[i] + a2 * w.cos2W[i];
+            const auto denIm = SIMDFloat::expand (0.0f) - (a1 * w.sinW[i] + a2 * w.sin2W[i]);
+            const auto denNorm = one / (denRe * denRe + denIm * denIm);
+
+            const auto hRe = (numRe * denRe + numIm * denIm) * denNorm;
+            const auto hIm = (numIm * denRe - numRe * denIm) * denNorm;
+
+            const auto re = block.re[i];
+            block.re[i] = re * hRe - block.im[i] * hIm;
+            block.im[i] = re * hIm + block.im[i] * hRe;
+        }
+    }
+
+    // Write magnitudes and (optionally) phases of the first numFrequencies lanes
+    void writeResponses (ComplexBlock block, float* magnitudes, float* phases, int numFrequencies)
+    {
+        for (int index = 0; index < numFrequencies; index++)
+        {
+            const auto re = block.re[size_t (index) / SIMDFloat::size()].get (size_t (index) % SIMDFloat::size());
+            const auto im = block.im[size_t (index) / SIMDFloat::size()].get (size_t (index) % SIMDFloat::size());
+            magnitudes[index] = sqrt (re * re + im * im);
+            if (phases != nullptr)
+                phases[index] = atan2 (im, re);
+        }
+    }
+}
+
+//==============================================================================
+void FilterInfo::ResponseScratch::prepare (int maxNumFrequencies)
+{
+    const auto numBlocks = (size_t (jmax (0, maxNumFrequencies)) + SIMDFloat::size() - 1) / SIMDFloat::size();
+    for (auto* buffer : { &cosW, &sinW, &cos2W, &sin2W, &re, &im, &bandRe, &bandIm, &remainderRe, &remainderIm })
+        buffer->resize (numBlocks);
+}
+
 //==============================================================================
 FilterResponse::FilterResponse (double magnitudeInit, double phaseInit)
 {
@@ -45,13 +193,102 @@ void FilterInfo::setGain (double gain)
 
 FilterResponse FilterInfo::getResponse (double inputFrequency) const
 {
-	const double mag = filters[0].coefficients.get()->getMagnitudeForFrequency(inputFrequency, fs);
-	const double phase = filters[0].coefficients.get()->getPhaseForFrequency(inputFrequency, fs);
+	// The crossover cascades two identical Butterworth sections per band (Linkwitz-Riley),
+	// so the response is the squared magnitude and doubled phase of one section
+	const double sectionMag = filters[0].coefficients.get()->getMagnitudeForFrequency(inputFrequency, fs);
+	const double mag = sectionMag * sectionMag;
+	const double phase = 2.0 * filters[0].coefficients.get()->getPhaseForFrequency(inputFrequency, fs);
 
 	// Wrap in FilterResponse
     return FilterResponse(mag, phase);
 }
 
+void FilterInfo::getResponses (const float* frequencies, float* magnitudes, float* phases, int numFrequencies,
+                               ResponseScratch& scratch) const
+{
+    const auto numBlocks = setFrequencies (scratch, frequencies, numFrequencies, fs);
+    const ComplexBlock response { scratch.re.data(), scratch.im.data() };
+    fillBlock (response, numBlocks, 1.0f);
+
+    // Two identical Butterworth sections (Linkwitz-Riley), as in getResponse()
+    const auto section = toBiquad (getCoefficients());
+    multiplyByBiquad (response, scratch, numBlocks, section);
+    multiplyByBiquad (response, scratch, numBlocks, section);
+
+    writeResponses (response, magnitudes, phases, numFrequencies);
+}
+
+void FilterInfo::getCrossoverSumResponses (const float* crossoverFrequencies, int numCrossovers, bool phaseCompensation,
+                                           double sampleRate, const float* frequencies, float* magnitudes, float* phases,
+                                           int numFrequencies, ResponseScratch& scratch)
+{
+    const auto numBlocks = setFrequencies (scratch, frequencies, numFrequencies, sampleRate);
+    const ComplexBlock sum { scratch.re.data(), scratch.im.data() };
+    const ComplexBlock band { scratch.bandRe.data(), scratch.bandIm.data() };
+    // Part of the signal that is not split off yet, i.e. the highpasses of all crossovers below
+    const ComplexBlock remainder { scratch.remainderRe.data(), scratch.remainderIm.data() };
+    fillBlock (sum, numBlocks, 0.0f);
+    fillBlock (remainder, numBlocks, 1.0f);
+
+    for (int k = 0; k < numCrossovers; k++)
+    {
+        // Band k is the LR4 lowpass of the remainder
+        const auto lowpass = makeLowPass (sampleRate, crossoverFrequencies[k]);
+        copyBlock (remainder, band, numBlocks);
+        multiplyByBiquad (band, scratch, numBlocks, lowpass);
+        multiplyByBiquad (band, scratch, numBlocks, lowpass);
+
+        for (int j = k + 1; phaseCompensation && j < numCrossovers; j++)
+            multiplyByBiquad (band, scratch, numBlocks, makeAllPass (sampleRate, crossoverFrequencies[j]));
+
+        addBlock (band, sum, numBlocks);
+
+        const auto highpass = makeHighPass (sampleRate, crossoverFrequencies[k]);
+        multiplyByBiquad (remainder, scratch, numBlocks, highpass);
+        multiplyByBiquad (remainder, scratch, numBlocks, highpass);
+    }
+
+    // The top band is the remainder
+    addBlock (remainder, sum, numBlocks);
+
+    writeResponses (sum, magnitudes, phases, numFrequencies);
+}
+
+void FilterInfo::getCrossoverBandResponses (const float* crossoverFrequencies, int numCrossovers, bool phaseCompensation,
+                                            double sampleRate, int band, const float* frequencies, float* magnitudes,
+                                            float* phases, int numFrequencies, ResponseScratch& scratch)
+{
+    jassert (band >= 0 && band <= numCrossovers);
+    const auto numBlocks = setFrequencies (scratch, frequencies, numFrequencies, sampleRate);
+    const ComplexBlock response { scratch.re.data(), scratch.im.data() };
+    fillBlock (response, numBlocks, 1.0f);
+
+    // The remainder above all lower crossovers ...
+    for (int k = 0; k < band; k++)
+    {
+        const auto highpass = makeHighPass (sampleRate, crossoverFrequencies[k]);
+        multiplyByBiquad (response, scratch, numBlocks, highpass);
+        multiplyByBiquad (response, scratch, numBlocks, highpass);
+    }
+
+    // ... split off at the band's own crossover (the top band has none)
+    if (band < numCrossovers)
+    {
+        const auto lowpass = makeLowPass (sampleRate, crossoverFrequencies[band]);
+        multiplyByBiquad (response, scratch, numBlocks, lowpass);
+        multiplyByBiquad (response, scratch, numBlocks, lowpass);
+    }
+
+    for (int j = band + 1; phaseCompensation && j < numCrossovers; j++)
+        multiplyByBiquad (response, scratch, numBlocks, makeAllPass (sampleRate, crossoverFrequencies[j]));
+
+    writeResponses (response, magnitudes, phases, numFrequencies);
+}
+
 FilterInfo::FilterType FilterInfo::getFilterType() {
     return filterType;
+}
+
+const Array<float>& FilterInfo::getCoefficients() const {
+    return filters[0].coefficients->coefficients;
 }
\ No newline at end of file
@@ -57,6 +57,22 @@ public:
         HIGHPASS
     };
 
+    /**
+     * Buffers for the batch responses, so evaluating a curve doesn't allocate. Prepared by the caller for the largest
+     * number of frequencies it evaluates, e.g. whenever the display is resized.
+     */
+    struct ResponseScratch
+    {
+        using SIMDFloat = dsp::SIMDRegister<float>;
+
+        void prepare (int maxNumFrequencies);
+
+        // e^-jw and e^-2jw of the frequencies, one lane per frequency
+        vector<SIMDFloat> cosW, sinW, cos2W, sin2W;
+        // Complex responses: the result, one band and the remainder of a band bank
+        vector<SIMDFloat> re, im, bandRe, bandIm, remainderRe, remainderIm;
+    };
+
     FilterInfo(array<dsp::IIR::Filter<float>, 2>& filters, FilterType type, double sampleRate, AudioProcessorValueTreeState& valueTreeState);
     ~FilterInfo();
     
@@ -68,9 +84,49 @@ public:
 	// methods to generate the paths used to draw the filter visualisation in the FilterGraph
     FilterResponse getResponse (double inputFrequency) const;
 
+    /**
+     * Batch version of getResponse(), evaluating all frequencies in one vectorised pass over the coefficients
+     * @param frequencies Frequencies in Hz
+     * @param magnitudes Destination for the (linear) magnitudes
+     * @param phases Destination for the phases in radians, may be nullptr if only the magnitudes are needed
+     * @param numFrequencies Number of frequencies
+     * @param scratch Buffers prepared for at least numFrequencies
+     */
+    void getResponses (const float* frequencies, float* magnitudes, float* phases, int numFrequencies,
+                       ResponseScratch& scratch) const;
+
+    /**
+     * Response of the sum of all bands of an LR4 band bank (see LinkwitzRileyCrossover), e.g. to display how well the
+     * bands reconstruct the input
+     * @param crossoverFrequencies Ascending crossover frequencies in Hz
+     * @param numCrossovers Number of crossovers, one less than the number of bands
+     * @param phaseCompensation Whether the bands are passed through the allpasses of the crossovers above them
+     * @param sampleRate Sample rate of the band bank
+     * @param frequencies Frequencies in Hz at which the response is evaluated
+     * @param magnitudes Destination for the (linear) magnitudes
+     * @param phases Destination for the phases in radians, may be nullptr if only the magnitudes are needed
+     * @param numFrequencies Number of frequencies
+     * @param scratch Buffers prepared for at least numFrequencies
+     */
+    static void getCrossoverSumResponses (const float* crossoverFrequencies, int numCrossovers, bool phaseCompensation,
+                                          double sampleRate, const float* frequencies, float* magnitudes, float* phases,
+                                          int numFrequencies, ResponseScratch& scratch);
+
+    /**
+     * Response of a single band of an LR4 band bank (see LinkwitzRileyCrossover), e.g. to display the bands between the
+     * lowest and the highest crossover. The parameters are the same as for getCrossoverSumResponses().
+     * @param band Index of the band, 0 is the lowest and numCrossovers the highest
+     */
+    static void getCrossoverBandResponses (const float* crossoverFrequencies, int numCrossovers, bool phaseCompensation,
+                                           double sampleRate, int band, const float* frequencies, float* magnitudes,
+                                           float* phases, int numFrequencies, ResponseScratch& scratch);
+
     // Get the filter type (lowpass/highpass)
     FilterType getFilterType();
 
+    // Coefficients of the displayed filter section, used to detect changes of the response
+    const Array<float>& getCoefficients() const;
+
 private:
     // Filter type: 0 = lowpass, 1 = highpass
     FilterType filterType = LOWPASS;